@@ -3,9 +3,11 @@
 //
 
 #include "App.h"
+#include "Util/Telemetry.h"
 
 void App::InitializeScene(Scene &scene) {
 	_current = 0;
+	_frame_id = 0;
 	for (const auto& object : _system.GetObjects()) {
 		scene.AddMesh();
 		scene.SetMesh(object->GetSurfacePosition(), object->GetSurfaceTopo());
@@ -18,7 +20,11 @@ void App::Processing(Scene &scene) {
 	if (_current > _duration) {
 		glfwSetWindowShouldClose(GUI::window, 1);
 	}
-	_integrator->Step(_system, *_contact, *_friction, _step);
+	TELEMETRY(SetFrame(_frame_id++));
+	if (!_integrator->Step(_system, *_contact, *_friction, _step)) {
+		glfwSetWindowShouldClose(GUI::window, 1);
+		return;
+	}
 	int idx = 0;
 	for (const auto& object : _system.GetObjects()) {
 		scene.SelectData(idx++);
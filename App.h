@@ -15,6 +15,7 @@ public:
 
 protected:
 	double _current;
+	int _frame_id;
 };
 
 #endif //FEM_APP_H
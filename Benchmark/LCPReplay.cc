@@ -0,0 +1,251 @@
+// Replay recorded contact problems through every LCP solver.
+// Usage: lcp-replay [--max-step n] [--tolerance e] [--cold] file...
+// The files are produced by setting "record-file" in the solver config.
+// Polygonal problems are replayed with the staggering iteration of
+// StaggerLCPIntegrator, the normal LCP going through the solver under test and
+// the friction QP through OSQP. Cone problems go through the cone PGS, the
+// LCP solvers only see their frictionless steps, as in ConeIntegrator.
+//
+
+#include "Util/Factory.h"
+#include "NumericSolver/LCPSolver/LCPRecorder.h"
+#include "NumericSolver/LCPSolver/PGS.h"
+#include "NumericSolver/LCPSolver/BGS.h"
+#include "NumericSolver/LCPSolver/PivotingMethod.h"
+#include "NumericSolver/LCPSolver/OSQPWrapper.h"
+#include "NumericSolver/LCPSolver/AdaptiveLCPSolver.h"
+#include "NumericSolver/LCPSolver/BoxQP.h"
+#include "NumericSolver/LCPSolver/ConePGS.h"
+#include <OsqpEigen/OsqpEigen.h>
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct SolverEntry {
+	std::string _name;
+	LCPSolver* _solver;		// nullptr for the cone PGS
+
+	double _total_time = 0;
+	long long _total_iterations = 0;
+	double _max_error = 0;
+	int _num_instance = 0;
+	int _num_failure = 0;
+};
+
+/**
+ * Residual of the polygonal friction problem with variables [xn, xt]:
+ * 		xn >= 0, yn >= 0, xn^T yn = 0
+ * 		xt >= 0, yt + E lambda >= 0, xt^T (yt + E lambda) = 0
+ * 		lambda >= 0, mu xn - E^T xt >= 0, lambda^T (mu xn - E^T xt) = 0
+ * where y = Ax + b, E sums the tangents of a contact and lambda, the sliding
+ * speed, is the least one making yt + E lambda nonnegative
+ */
+double PolygonError(const LCPInstance &instance, const VectorXd &x) {
+	const int num_contact = instance._num_contact, num_tangent = instance._num_tangent;
+	const VectorXd y = instance._A * x + instance._b;
+	double error = x.head(num_contact).cwiseMin(y.head(num_contact)).cwiseAbs().maxCoeff();
+	for (int i = 0; i < num_contact; i++) {
+		const auto xt = x.segment(num_contact + i * num_tangent, num_tangent);
+		const auto yt = y.segment(num_contact + i * num_tangent, num_tangent);
+		const double lambda = std::max(0.0, -yt.minCoeff());
+		const double slack = instance._mu(i) * x(i) - xt.sum();
+		error = std::max(error, xt.cwiseMin((yt.array() + lambda).matrix()).cwiseAbs().maxCoeff());
+		error = std::max(error, std::abs(std::min(lambda, slack)));
+	}
+	return error;
+}
+
+//-> Residual of the natural map x - P_K(x - (Ax + b)) of the cone complementarity problem
+double ConeError(const LCPInstance &instance, const VectorXd &x) {
+	const VectorXd y = instance._A * x + instance._b;
+	double error = 0;
+	for (int i = 0; i < instance._num_contact; i++) {
+		Eigen::Vector3d x_i = x.segment<3>(3 * i) - y.segment<3>(3 * i);
+		ConePGS::Project(instance._mu(i), x_i);
+		error = std::max(error, (x.segment<3>(3 * i) - x_i).cwiseAbs().maxCoeff());
+	}
+	return error;
+}
+
+/**
+ * The staggering iteration of StaggerLCPIntegrator on a polygonal problem
+ * @param x INPUT & OUTPUT, the warm start on input and the solution on output
+ * @return total number of iterations spent by the LCP solver
+ */
+int Stagger(const LCPInstance &instance, const LCPSolver &solver,
+			int max_step, double tolerance, VectorXd &x) {
+	const int num_contact = instance._num_contact, num_tangent = instance._num_tangent;
+	const int num_friction = num_contact * num_tangent;
+	const MatrixXd Ann = instance._A.topLeftCorner(num_contact, num_contact);
+	const MatrixXd Ant = instance._A.topRightCorner(num_contact, num_friction);
+	const MatrixXd Atn = instance._A.bottomLeftCorner(num_friction, num_contact);
+	const VectorXd bn = instance._b.head(num_contact), bt = instance._b.tail(num_friction);
+
+	SparseMatrixXd friction_hessian;
+	OSQPWrapper::ToFullPattern(instance._A.bottomRightCorner(num_friction, num_friction), friction_hessian);
+	COO friction_constraint_COO;
+	for (int i = 0; i < num_friction; i++) {
+		friction_constraint_COO.push_back(Tripletd(i, i, 1));
+	}
+	for (int i = 0; i < num_contact; i++) {
+		for (int j = 0; j < num_tangent; j++) {
+			friction_constraint_COO.push_back(Tripletd(num_friction + i, num_tangent * i + j, -1));
+		}
+	}
+	SparseMatrixXd friction_constraint(num_friction + num_contact, num_friction);
+	friction_constraint.setFromTriplets(friction_constraint_COO.begin(), friction_constraint_COO.end());
+	VectorXd lower_bound = VectorXd::Zero(num_friction + num_contact);
+	VectorXd upper_bound = VectorXd::Constant(num_friction + num_contact, OsqpEigen::INFTY);
+	lower_bound.tail(num_contact) = -instance._mu.cwiseProduct(x.head(num_contact));
+	VectorXd friction_gradient = Atn * x.head(num_contact) + bt;
+
+	OsqpEigen::Solver friction_solver;
+	friction_solver.settings()->setWarmStart(true);
+	friction_solver.settings()->setVerbosity(false);
+	friction_solver.data()->setNumberOfVariables(num_friction);
+	friction_solver.data()->setNumberOfConstraints(num_friction + num_contact);
+	friction_solver.data()->setHessianMatrix(friction_hessian);
+	friction_solver.data()->setLinearConstraintsMatrix(friction_constraint);
+	friction_solver.data()->setLowerBound(lower_bound);
+	friction_solver.data()->setUpperBound(upper_bound);
+	friction_solver.data()->setGradient(friction_gradient);
+	friction_solver.initSolver();
+
+	const DenseLCPOperator contact_operator(Ann);
+	VectorXd xn(num_contact), contact_gradient(num_contact);
+	int iterations = 0;
+	for (int step = 0; step < max_step; step++) {
+		contact_gradient = bn + Ant * x.tail(num_friction);
+		xn = x.head(num_contact);
+		solver.Solve(contact_operator, contact_gradient, xn);
+		iterations += std::max(solver.GetNumIterations(), 0);
+		friction_gradient = Atn * xn + bt;
+		friction_solver.updateGradient(friction_gradient);
+		lower_bound.tail(num_contact) = -instance._mu.cwiseProduct(xn);
+		friction_solver.updateLowerBound(lower_bound);
+		friction_solver.solveProblem();
+		const VectorXd& xt = friction_solver.getSolution();
+		const double error_n = (xn - x.head(num_contact)).norm();
+		const double error_t = (xt - x.tail(num_friction)).norm();
+		x << xn, xt;
+		if (error_n < tolerance && error_t < tolerance) {
+			break;
+		}
+	}
+	return iterations;
+}
+
+int main(int argc, char* argv[]) {
+	int max_step = 300;
+	double tolerance = 1e-3;
+	bool cold = false;
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--max-step" && i + 1 < argc) {
+			max_step = std::stoi(argv[++i]);
+		} else if (arg == "--tolerance" && i + 1 < argc) {
+			tolerance = std::stod(argv[++i]);
+		} else if (arg == "--cold") {
+			cold = true;
+		} else {
+			files.push_back(arg);
+		}
+	}
+	if (files.empty()) {
+		std::fprintf(stderr, "Usage: %s [--max-step n] [--tolerance e] [--cold] file...\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	spdlog::set_level(spdlog::level::err);
+
+	auto factory = LCPSolverFactory::GetInstance();
+	std::vector<SolverEntry> solvers = {
+		{"PGS", factory->GetLCPSolver(LCPSolverType::kPGS)},
+		{"PGS-mixed", factory->GetLCPSolver(LCPSolverType::kPGS)},
+		{"BGS", factory->GetLCPSolver(LCPSolverType::kBGS)},
+		{"Pivot", factory->GetLCPSolver(LCPSolverType::kPivot)},
+		{"OSQP", factory->GetLCPSolver(LCPSolverType::kOSQP)},
+		{"Adaptive", factory->GetLCPSolver(LCPSolverType::kAdaptive)},
+		{"BoxQP", factory->GetLCPSolver(LCPSolverType::kBoxQP)},
+		{"ConePGS", nullptr},
+	};
+	solvers[0]._solver->Initialize(PGSParameter(max_step, tolerance, 1));
+	solvers[1]._solver->Initialize(PGSParameter(max_step, tolerance, 1, true));
+	solvers[2]._solver->Initialize(BGSParameter(max_step, tolerance));
+	solvers[3]._solver->Initialize(PivotingMethodParameter(max_step, tolerance));
+	solvers[4]._solver->Initialize(OSQPWrapperParameter(max_step, tolerance));
+	solvers[5]._solver->Initialize(AdaptiveLCPSolverParameter(max_step, tolerance));
+	solvers[6]._solver->Initialize(BoxQPParameter(max_step, tolerance));
+	ConePGS cone_solver;
+	cone_solver.Initialize(PGSParameter(max_step, tolerance, 1));
+
+	std::printf("%-24s %6s %6s %10s %12s %6s %12s\n",
+				"file", "frame", "size", "solver", "time(ms)", "iters", "error");
+
+	int num_instance = 0;
+	for (const auto& file : files) {
+		LCPReader reader;
+		if (!reader.Open(file)) {
+			continue;
+		}
+		LCPInstance instance;
+		while (reader.Next(instance)) {
+			num_instance++;
+			const int size = instance._b.size();
+			const int num_contact = instance._num_contact;
+			const bool cone = instance._friction_type == LCPFrictionType::kCone;
+			const bool frictionless = instance._mu.isZero();
+			for (auto& entry : solvers) {
+				// the cone PGS only handles cone problems, the LCP solvers only frictionless ones among them
+				if (cone ? entry._solver != nullptr && !frictionless : entry._solver == nullptr) {
+					continue;
+				}
+				VectorXd x = cold ? VectorXd::Zero(size) : instance._x0;
+				int iterations;
+				auto start = std::chrono::steady_clock::now();
+				if (!cone) {
+					iterations = Stagger(instance, *entry._solver, max_step, tolerance, x);
+				} else if (entry._solver == nullptr) {
+					cone_solver.Solve(DenseLCPOperator(instance._A), instance._b, instance._mu, x);
+					iterations = cone_solver.GetNumIterations();
+				} else {
+					const auto normal = Eigen::seqN(0, num_contact, 3);
+					VectorXd xn = x(normal);
+					entry._solver->Solve(DenseLCPOperator(instance._A(normal, normal)), instance._b(normal), xn);
+					iterations = entry._solver->GetNumIterations();
+					x.setZero();
+					x(normal) = xn;
+				}
+				auto end = std::chrono::steady_clock::now();
+
+				const double time = std::chrono::duration<double, std::milli>(end - start).count();
+				const double error = cone ? ConeError(instance, x) : PolygonError(instance, x);
+
+				entry._num_instance++;
+				entry._total_time += time;
+				entry._total_iterations += std::max(iterations, 0);
+				entry._max_error = std::max(entry._max_error, error);
+				if (error > tolerance) {
+					entry._num_failure++;
+				}
+				std::printf("%-24s %6d %6d %10s %12.3f %6d %12.3e\n",
+							file.c_str(), instance._frame_id, size,
+							entry._name.c_str(), time, iterations, error);
+			}
+		}
+	}
+
+	std::printf("\nSummary over %d instances\n", num_instance);
+	std::printf("%10s %10s %14s %12s %12s %8s\n", "solver", "instances", "total(ms)", "avg iters", "max error", "failed");
+	for (auto& entry : solvers) {
+		std::printf("%10s %10d %14.3f %12.2f %12.3e %8d\n", entry._name.c_str(),
+					entry._num_instance, entry._total_time,
+					entry._num_instance > 0 ? (double) entry._total_iterations / entry._num_instance : 0.0,
+					entry._max_error, entry._num_failure);
+		delete entry._solver;
+	}
+	return 0;
+}
@@ -0,0 +1,394 @@
+#include "BVH.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace {
+	const int kLeafSize = 4;			// maximum number of triangles in a leaf
+	const double kRebuildRatio = 2;		// rebuild once refitting doubles the cost
+
+	double Angle(const Vector3d &a, const Vector3d &b) {
+		return std::acos(std::max(-1.0, std::min(1.0, a.dot(b))));
+	}
+}
+
+AABB::AABB()
+	: _min(Vector3d::Constant(std::numeric_limits<double>::max())),
+	  _max(Vector3d::Constant(std::numeric_limits<double>::lowest())) {}
+
+void AABB::Extend(const Vector3d &point) {
+	_min = _min.cwiseMin(point);
+	_max = _max.cwiseMax(point);
+}
+
+void AABB::Extend(const AABB &box) {
+	_min = _min.cwiseMin(box._min);
+	_max = _max.cwiseMax(box._max);
+}
+
+bool AABB::Overlap(const AABB &rhs) const {
+	return (_min.array() <= rhs._max.array()).all() && (rhs._min.array() <= _max.array()).all();
+}
+
+Vector3d AABB::Center() const {
+	return (_min + _max) / 2;
+}
+
+double AABB::SurfaceArea() const {
+	const Vector3d extent = (_max - _min).cwiseMax(0.0);
+	return 2 * (extent(0) * extent(1) + extent(1) * extent(2) + extent(2) * extent(0));
+}
+
+AABB AABB::Transformed(const Matrix3d &rotation, const Vector3d &translation) const {
+	AABB box;
+	const Vector3d center = rotation * Center() + translation;
+	const Vector3d extent = rotation.cwiseAbs() * (_max - _min) / 2;
+	box._min = center - extent;
+	box._max = center + extent;
+	return box;
+}
+
+AABB AABB::Inflated(double margin) const {
+	AABB box;
+	box._min = _min - Vector3d::Constant(margin);
+	box._max = _max + Vector3d::Constant(margin);
+	return box;
+}
+
+AABB BVH::TriangleBox(const RowMatrixX3dRef &vertices, const Matrix<int, Dynamic, 3> &topo, int i) {
+	AABB box;
+	for (int j = 0; j < 3; j++) {
+		box.Extend(vertices.row(topo(i, j)).transpose());
+	}
+	return box;
+}
+
+void BVH::Build(const RowMatrixX3dRef &vertices, const Matrix<int, Dynamic, 3> &topo) {
+	const int num_faces = topo.rows();
+	_primitive_boxes.resize(num_faces);
+	_centers.resize(num_faces);
+	_primitives.resize(num_faces);
+	_topo = topo;
+	for (int i = 0; i < num_faces; i++) {
+		_primitive_boxes[i] = TriangleBox(vertices, topo, i);
+		_centers[i] = _primitive_boxes[i].Center();
+		_primitives[i] = i;
+	}
+
+	_nodes.clear();
+	_nodes.reserve(2 * num_faces / kLeafSize + 1);
+	BuildNode(0, num_faces);
+	UpdateCones(vertices);
+	_build_cost = Cost();
+}
+
+void BVH::Refit(const RowMatrixX3dRef &vertices) {
+	const int num_faces = _topo.rows();
+	#pragma omp parallel for
+	for (int i = 0; i < num_faces; i++) {
+		_primitive_boxes[i] = TriangleBox(vertices, _topo, i);
+	}
+	RefitNodes();
+	UpdateCones(vertices);
+}
+
+void BVH::Build(const RowMatrixX3dRef &start, const RowMatrixX3dRef &end, const Matrix<int, Dynamic, 3> &topo) {
+	Build(start, topo);
+	Refit(start, end);
+	_build_cost = Cost();
+}
+
+void BVH::Refit(const RowMatrixX3dRef &start, const RowMatrixX3dRef &end) {
+	const int num_faces = _topo.rows();
+	#pragma omp parallel for
+	for (int i = 0; i < num_faces; i++) {
+		_primitive_boxes[i] = TriangleBox(start, _topo, i);
+		_primitive_boxes[i].Extend(TriangleBox(end, _topo, i));
+	}
+	RefitNodes();
+	UpdateCones(start);
+}
+
+void BVH::RefitNodes() {
+	const int num_nodes = _nodes.size();
+	#pragma omp parallel for
+	for (int i = 0; i < num_nodes; i++) {
+		auto& node = _nodes[i];
+		if (node.IsLeaf()) {
+			node._box = AABB();
+			for (int j = node._begin; j < node._end; j++) {
+				node._box.Extend(_primitive_boxes[_primitives[j]]);
+			}
+		}
+	}
+
+	// Children always come after their parent
+	for (int i = num_nodes - 1; i >= 0; i--) {
+		auto& node = _nodes[i];
+		if (!node.IsLeaf()) {
+			node._box = _nodes[node._left]._box;
+			node._box.Extend(_nodes[node._right]._box);
+		}
+	}
+}
+
+void BVH::UpdateCones(const RowMatrixX3dRef &vertices) {
+	const int num_faces = _topo.rows();
+	_normals.resize(num_faces);
+	#pragma omp parallel for
+	for (int i = 0; i < num_faces; i++) {
+		const Vector3d a = vertices.row(_topo(i, 0)), b = vertices.row(_topo(i, 1)), c = vertices.row(_topo(i, 2));
+		_normals[i] = (b - a).cross(c - a).normalized();
+	}
+
+	const int num_nodes = _nodes.size();
+	#pragma omp parallel for
+	for (int i = 0; i < num_nodes; i++) {
+		auto& node = _nodes[i];
+		if (node.IsLeaf()) {
+			Vector3d axis = Vector3d::Zero();
+			for (int j = node._begin; j < node._end; j++) {
+				axis += _normals[_primitives[j]];
+			}
+			if (axis.norm() < 1e-8) {
+				node._cone_angle = M_PI;
+				continue;
+			}
+			node._cone_axis = axis.normalized();
+			node._cone_angle = 0;
+			for (int j = node._begin; j < node._end; j++) {
+				node._cone_angle = std::max(node._cone_angle, Angle(node._cone_axis, _normals[_primitives[j]]));
+			}
+		}
+	}
+
+	for (int i = num_nodes - 1; i >= 0; i--) {
+		auto& node = _nodes[i];
+		if (node.IsLeaf()) {
+			continue;
+		}
+		const auto& left = _nodes[node._left];
+		const auto& right = _nodes[node._right];
+		const Vector3d axis = left._cone_axis + right._cone_axis;
+		if (left._cone_angle >= M_PI || right._cone_angle >= M_PI || axis.norm() < 1e-8) {
+			node._cone_angle = M_PI;
+			continue;
+		}
+		node._cone_axis = axis.normalized();
+		node._cone_angle = std::min(M_PI, std::max(Angle(node._cone_axis, left._cone_axis) + left._cone_angle,
+												   Angle(node._cone_axis, right._cone_axis) + right._cone_angle));
+	}
+}
+
+bool BVH::IsConnected(int begin, int end) const {
+	// Union find over the triangles, joined through the vertices they share
+	const int num = end - begin;
+	std::vector<int> parent(num);
+	for (int i = 0; i < num; i++) {
+		parent[i] = i;
+	}
+	const auto find = [&parent](int i) {
+		while (parent[i] != i) {
+			i = parent[i] = parent[parent[i]];
+		}
+		return i;
+	};
+
+	std::vector<std::pair<int, int>> vertices;	// (vertex, triangle)
+	vertices.reserve(3 * num);
+	for (int i = 0; i < num; i++) {
+		for (int j = 0; j < 3; j++) {
+			vertices.emplace_back(_topo(_primitives[begin + i], j), i);
+		}
+	}
+	std::sort(vertices.begin(), vertices.end());
+	int num_components = num;
+	const int num_vertices = vertices.size();
+	for (int i = 1; i < num_vertices; i++) {
+		if (vertices[i].first == vertices[i - 1].first) {
+			const int root1 = find(vertices[i].second), root2 = find(vertices[i - 1].second);
+			if (root1 != root2) {
+				parent[root1] = root2;
+				num_components--;
+			}
+		}
+	}
+	return num_components <= 1;
+}
+
+bool BVH::IsAdjacent(int triangle1, int triangle2) const {
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			if (_topo(triangle1, i) == _topo(triangle2, j)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+double BVH::Cost() const {
+	if (_nodes.empty()) {
+		return 0;
+	}
+	const double root_area = _nodes[0]._box.SurfaceArea();
+	if (root_area <= 0) {
+		return 0;
+	}
+	double area = 0;
+	for (const auto& node : _nodes) {
+		if (!node.IsLeaf()) {
+			area += node._box.SurfaceArea();
+		}
+	}
+	return area / root_area;
+}
+
+bool BVH::IsDegraded() const {
+	return Cost() > kRebuildRatio * _build_cost;
+}
+
+int BVH::BuildNode(int begin, int end) {
+	const int id = _nodes.size();
+	_nodes.emplace_back();
+
+	AABB box, center_box;
+	for (int i = begin; i < end; i++) {
+		box.Extend(_primitive_boxes[_primitives[i]]);
+		center_box.Extend(_centers[_primitives[i]]);
+	}
+	_nodes[id]._box = box;
+	_nodes[id]._begin = begin;
+	_nodes[id]._end = end;
+	_nodes[id]._connected = IsConnected(begin, end);
+	if (end - begin <= kLeafSize) {
+		return id;
+	}
+
+	int axis;
+	(center_box._max - center_box._min).maxCoeff(&axis);
+	const int mid = (begin + end) / 2;
+	std::nth_element(_primitives.begin() + begin, _primitives.begin() + mid, _primitives.begin() + end,
+					 [this, axis](int lhs, int rhs) {
+						 return _centers[lhs](axis) < _centers[rhs](axis);
+					 });
+
+	// _nodes may reallocate during the recursion, index instead of referencing
+	const int left = BuildNode(begin, mid);
+	const int right = BuildNode(mid, end);
+	_nodes[id]._left = left;
+	_nodes[id]._right = right;
+	return id;
+}
+
+const AABB& BVH::GetBox() const {
+	static const AABB empty;
+	return _nodes.empty() ? empty : _nodes[0]._box;
+}
+
+void BVH::Intersect(const BVH &rhs, std::vector<std::pair<int, int>> &pairs) const {
+	Intersect(rhs, Matrix3d::Identity(), Vector3d::Zero(), pairs);
+}
+
+void BVH::Intersect(const BVH &rhs, const Matrix3d &rotation, const Vector3d &translation,
+					std::vector<std::pair<int, int>> &pairs, double margin) const {
+	pairs.clear();
+	if (_nodes.empty() || rhs._nodes.empty()) {
+		return;
+	}
+
+	std::vector<std::pair<int, int>> stack;
+	stack.emplace_back(0, 0);
+	while (!stack.empty()) {
+		const auto [id1, id2] = stack.back();
+		stack.pop_back();
+		const Node &node1 = _nodes[id1];
+		const Node &node2 = rhs._nodes[id2];
+		if (!node1._box.Overlap(node2._box.Transformed(rotation, translation).Inflated(margin))) {
+			continue;
+		}
+
+		if (node1.IsLeaf() && node2.IsLeaf()) {
+			for (int i = node1._begin; i < node1._end; i++) {
+				const int face1 = _primitives[i];
+				for (int j = node2._begin; j < node2._end; j++) {
+					const int face2 = rhs._primitives[j];
+					if (_primitive_boxes[face1].Overlap(rhs._primitive_boxes[face2].Transformed(rotation, translation).Inflated(margin))) {
+						pairs.emplace_back(face1, face2);
+					}
+				}
+			}
+		} else if (node2.IsLeaf() || (!node1.IsLeaf() && node1._box.SurfaceArea() >= node2._box.SurfaceArea())) {
+			// descend into the larger box
+			stack.emplace_back(node1._left, id2);
+			stack.emplace_back(node1._right, id2);
+		} else {
+			stack.emplace_back(id1, node2._left);
+			stack.emplace_back(id1, node2._right);
+		}
+	}
+
+	// keep the order of the brute force loop, so the contacts are deterministic
+	std::sort(pairs.begin(), pairs.end());
+}
+
+void BVH::SelfIntersect(std::vector<std::pair<int, int>> &pairs) const {
+	pairs.clear();
+	if (_nodes.empty()) {
+		return;
+	}
+
+	// (id, id) stands for the node against itself
+	std::vector<std::pair<int, int>> stack;
+	stack.emplace_back(0, 0);
+	while (!stack.empty()) {
+		const auto [id1, id2] = stack.back();
+		stack.pop_back();
+		const Node &node1 = _nodes[id1];
+		const Node &node2 = _nodes[id2];
+
+		if (id1 == id2) {
+			if (node1._connected && node1._cone_angle < M_PI / 2) {
+				continue;
+			}
+			if (node1.IsLeaf()) {
+				for (int i = node1._begin; i < node1._end; i++) {
+					for (int j = i + 1; j < node1._end; j++) {
+						const int face1 = _primitives[i], face2 = _primitives[j];
+						if (!IsAdjacent(face1, face2) && _primitive_boxes[face1].Overlap(_primitive_boxes[face2])) {
+							pairs.emplace_back(std::min(face1, face2), std::max(face1, face2));
+						}
+					}
+				}
+			} else {
+				stack.emplace_back(node1._left, node1._left);
+				stack.emplace_back(node1._right, node1._right);
+				stack.emplace_back(node1._left, node1._right);
+			}
+			continue;
+		}
+
+		if (!node1._box.Overlap(node2._box)) {
+			continue;
+		}
+		if (node1.IsLeaf() && node2.IsLeaf()) {
+			for (int i = node1._begin; i < node1._end; i++) {
+				const int face1 = _primitives[i];
+				for (int j = node2._begin; j < node2._end; j++) {
+					const int face2 = _primitives[j];
+					if (!IsAdjacent(face1, face2) && _primitive_boxes[face1].Overlap(_primitive_boxes[face2])) {
+						pairs.emplace_back(std::min(face1, face2), std::max(face1, face2));
+					}
+				}
+			}
+		} else if (node2.IsLeaf() || (!node1.IsLeaf() && node1._box.SurfaceArea() >= node2._box.SurfaceArea())) {
+			stack.emplace_back(node1._left, id2);
+			stack.emplace_back(node1._right, id2);
+		} else {
+			stack.emplace_back(id1, node2._left);
+			stack.emplace_back(id1, node2._right);
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+}
@@ -0,0 +1,139 @@
+#ifndef FEM_BVH_H
+#define FEM_BVH_H
+
+#include "Util/EigenAll.h"
+#include <vector>
+#include <utility>
+
+struct AABB {
+	AABB();
+
+	//-> grow the box to contain the point / the box
+	void Extend(const Vector3d &point);
+	void Extend(const AABB &box);
+
+	bool Overlap(const AABB &rhs) const;
+	Vector3d Center() const;
+	double SurfaceArea() const;
+
+	//-> the box bounding this box after x -> rotation * x + translation
+	AABB Transformed(const Matrix3d &rotation, const Vector3d &translation) const;
+
+	//-> the box grown by margin on every side
+	AABB Inflated(double margin) const;
+
+	Vector3d _min, _max;
+};
+
+/**
+ * Bounding volume hierarchy of axis aligned boxes over the triangles of a
+ * surface. The tree is stored as a flat array of nodes, the root first, and
+ * each leaf holds a few consecutive entries of a permutation of the triangles.
+ * As long as the topology is kept, a deforming surface only needs its boxes
+ * refitted, until the tree has degraded enough to be worth a rebuild.
+ * Each node also bounds the normals of its triangles with a cone, to cull
+ * the self-collision tests of nearly flat patches.
+ */
+class BVH {
+public:
+	/**
+	 * Build the tree top-down, splitting the triangle centers at the median
+	 * of the longest axis of their bounding box
+	 * @param vertices INPUT, vertices of the surface, one in a row
+	 * @param topo INPUT, triangles of the surface, indices into vertices
+	 */
+	void Build(const RowMatrixX3dRef &vertices, const Matrix<int, Dynamic, 3> &topo);
+
+	/**
+	 * Recompute the boxes bottom-up for moved vertices, keeping the tree
+	 * @param vertices INPUT, vertices of the surface the tree is built on
+	 */
+	void Refit(const RowMatrixX3dRef &vertices);
+
+	/**
+	 * Swept versions of the above, each triangle is bounded over its linear
+	 * motion from start to end, the normals are those at start
+	 * @param start, end INPUT, vertices of the surface at the two ends of the motion
+	 */
+	void Build(const RowMatrixX3dRef &start, const RowMatrixX3dRef &end, const Matrix<int, Dynamic, 3> &topo);
+	void Refit(const RowMatrixX3dRef &start, const RowMatrixX3dRef &end);
+
+	//-> whether the refitted tree is much looser than the one originally built
+	bool IsDegraded() const;
+
+	const AABB& GetBox() const;
+
+	/**
+	 * Dual-tree traversal collecting the pairs of triangles whose boxes overlap
+	 * @param rhs INPUT, the other tree
+	 * @param pairs OUTPUT, it will be cleared and loaded with (triangle of this,
+	 * 		  triangle of rhs), sorted lexicographically
+	 */
+	void Intersect(const BVH &rhs, std::vector<std::pair<int, int>> &pairs) const;
+
+	/**
+	 * Same as above, for trees built in different frames
+	 * @param rotation, translation INPUT, map from the frame of rhs to the
+	 * 		  frame of this tree, boxes of rhs are bounded again after the map
+	 * @param margin INPUT, boxes less than it apart along every axis count
+	 * 		  as overlapping
+	 */
+	void Intersect(const BVH &rhs, const Matrix3d &rotation, const Vector3d &translation,
+				   std::vector<std::pair<int, int>> &pairs, double margin = 0) const;
+
+	/**
+	 * Traversal of the tree against itself collecting the pairs of triangles
+	 * with overlapping boxes that do not share a vertex. Subtrees forming a
+	 * connected patch with a normal cone narrower than a hemisphere are
+	 * skipped, as a patch bending less than that cannot fold onto itself.
+	 * @param pairs OUTPUT, it will be cleared and loaded with the pairs
+	 * 		  (triangle1, triangle2), triangle1 < triangle2, sorted lexicographically
+	 * @note The contour test of the normal cone criterion is not done, so
+	 * 		 a patch twisting around like a spiral staircase may be culled wrongly
+	 */
+	void SelfIntersect(std::vector<std::pair<int, int>> &pairs) const;
+
+protected:
+	struct Node {
+		AABB _box;
+		int _left = -1, _right = -1;	// children, -1 for leaves
+		int _begin = 0, _end = 0;		// range in _primitives of a leaf
+		Vector3d _cone_axis = Vector3d::UnitZ();
+		double _cone_angle = 0;			// half angle of the normal cone
+		bool _connected = false;		// whether the triangles form a connected patch
+		bool IsLeaf() const {
+			return _left == -1;
+		}
+	};
+
+	//-> build the subtree over _primitives[begin, end), return its index
+	int BuildNode(int begin, int end);
+
+	//-> recompute the boxes of the nodes bottom-up from _primitive_boxes
+	void RefitNodes();
+
+	//-> recompute the normals of the triangles and the normal cones bottom-up
+	void UpdateCones(const RowMatrixX3dRef &vertices);
+
+	//-> whether the triangles _primitives[begin, end) are connected through shared vertices
+	bool IsConnected(int begin, int end) const;
+
+	//-> whether the two triangles share a vertex
+	bool IsAdjacent(int triangle1, int triangle2) const;
+
+	//-> total surface area of the internal nodes relative to the root, the expected traversal cost
+	double Cost() const;
+
+	//-> box of the ith triangle
+	static AABB TriangleBox(const RowMatrixX3dRef &vertices, const Matrix<int, Dynamic, 3> &topo, int i);
+
+	std::vector<Node> _nodes;
+	std::vector<int> _primitives;			// permutation of the triangles
+	std::vector<AABB> _primitive_boxes;		// indexed by triangle
+	std::vector<Vector3d> _normals;			// indexed by triangle
+	std::vector<Vector3d> _centers;			// indexed by triangle, only used while building
+	Matrix<int, Dynamic, 3> _topo;
+	double _build_cost = 0;					// cost right after the last build
+};
+
+#endif //FEM_BVH_H
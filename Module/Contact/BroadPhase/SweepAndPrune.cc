@@ -0,0 +1,63 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+void SweepAndPrune::Reset(const std::vector<AABB> &boxes) {
+	const int num_boxes = boxes.size();
+	Vector3d mean = Vector3d::Zero(), square = Vector3d::Zero();
+	for (const auto& box : boxes) {
+		const Vector3d center = box.Center();
+		mean += center;
+		square += center.cwiseAbs2();
+	}
+	if (num_boxes > 0) {
+		mean /= num_boxes;
+		square /= num_boxes;
+	}
+	(square - mean.cwiseAbs2()).maxCoeff(&_axis);
+
+	_endpoints.clear();
+	for (int i = 0; i < num_boxes; i++) {
+		_endpoints.push_back(Endpoint{0, i, true});
+		_endpoints.push_back(Endpoint{0, i, false});
+	}
+}
+
+void SweepAndPrune::GetPairs(const std::vector<AABB> &boxes, std::vector<std::pair<int, int>> &pairs) {
+	pairs.clear();
+	if (_endpoints.size() != 2 * boxes.size()) {
+		Reset(boxes);
+	}
+
+	for (auto& endpoint : _endpoints) {
+		const auto& box = boxes[endpoint._id];
+		endpoint._value = endpoint._is_min ? box._min(_axis) : box._max(_axis);
+	}
+
+	// Insertion sort, nearly linear as the order barely changes between steps
+	const int num_endpoints = _endpoints.size();
+	for (int i = 1; i < num_endpoints; i++) {
+		const Endpoint endpoint = _endpoints[i];
+		int j = i - 1;
+		while (j >= 0 && endpoint < _endpoints[j]) {
+			_endpoints[j + 1] = _endpoints[j];
+			j--;
+		}
+		_endpoints[j + 1] = endpoint;
+	}
+
+	_active.clear();
+	for (const auto& endpoint : _endpoints) {
+		if (endpoint._is_min) {
+			for (int id : _active) {
+				if (boxes[id].Overlap(boxes[endpoint._id])) {
+					pairs.emplace_back(std::max(id, endpoint._id), std::min(id, endpoint._id));
+				}
+			}
+			_active.push_back(endpoint._id);
+		} else {
+			_active.erase(std::find(_active.begin(), _active.end(), endpoint._id));
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+}
@@ -0,0 +1,44 @@
+#ifndef FEM_SWEEPANDPRUNE_H
+#define FEM_SWEEPANDPRUNE_H
+
+#include "Contact/BVH/BVH.h"
+#include <vector>
+#include <utility>
+
+/**
+ * Sweep and prune over the boxes of the objects. The end points of the boxes
+ * along one axis are kept sorted between calls, and as the objects move only
+ * a little each step, an insertion sort brings them back in order in nearly
+ * linear time. Sweeping the sorted end points then only meets the boxes
+ * overlapping along the axis.
+ */
+class SweepAndPrune {
+public:
+	/**
+	 * @param boxes INPUT, world space boxes of the objects
+	 * @param pairs OUTPUT, it will be cleared and loaded with the pairs (i1, i2),
+	 * 		  i2 < i1, of overlapping boxes, sorted lexicographically
+	 */
+	void GetPairs(const std::vector<AABB> &boxes, std::vector<std::pair<int, int>> &pairs);
+
+protected:
+	struct Endpoint {
+		double _value;
+		int _id;
+		bool _is_min;
+
+		//-> min end points go first on ties, so touching boxes overlap
+		bool operator<(const Endpoint &rhs) const {
+			return _value < rhs._value || (_value == rhs._value && _is_min && !rhs._is_min);
+		}
+	};
+
+	//-> choose the axis along which the centers spread the most, and start over
+	void Reset(const std::vector<AABB> &boxes);
+
+	int _axis = 0;
+	std::vector<Endpoint> _endpoints;	// sorted along _axis
+	std::vector<int> _active;			// workspace for the sweep
+};
+
+#endif //FEM_SWEEPANDPRUNE_H
@@ -0,0 +1,139 @@
+#include "CCD.h"
+#include <algorithm>
+
+double PointTriangleDistance(const Vector3d &p, const Vector3d &a, const Vector3d &b, const Vector3d &c,
+							 Vector3d &barycentric) {
+	// Voronoi regions of the triangle, see Real-Time Collision Detection, 5.1.5
+	const Vector3d ab = b - a, ac = c - a, ap = p - a;
+	const double d1 = ab.dot(ap), d2 = ac.dot(ap);
+	if (d1 <= 0 && d2 <= 0) {
+		barycentric = Vector3d(1, 0, 0);
+		return ap.norm();
+	}
+	const Vector3d bp = p - b;
+	const double d3 = ab.dot(bp), d4 = ac.dot(bp);
+	if (d3 >= 0 && d4 <= d3) {
+		barycentric = Vector3d(0, 1, 0);
+		return bp.norm();
+	}
+	const double vc = d1 * d4 - d3 * d2;
+	if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+		const double v = d1 / (d1 - d3);
+		barycentric = Vector3d(1 - v, v, 0);
+		return (ap - v * ab).norm();
+	}
+	const Vector3d cp = p - c;
+	const double d5 = ab.dot(cp), d6 = ac.dot(cp);
+	if (d6 >= 0 && d5 <= d6) {
+		barycentric = Vector3d(0, 0, 1);
+		return cp.norm();
+	}
+	const double vb = d5 * d2 - d1 * d6;
+	if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+		const double w = d2 / (d2 - d6);
+		barycentric = Vector3d(1 - w, 0, w);
+		return (ap - w * ac).norm();
+	}
+	const double va = d3 * d6 - d5 * d4;
+	if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) {
+		const double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		barycentric = Vector3d(0, 1 - w, w);
+		return (bp - w * (c - b)).norm();
+	}
+	const double denominator = va + vb + vc;
+	if (denominator <= 0) {
+		// degenerated triangle, fall back to its edges
+		double s, t;
+		double distance = EdgeEdgeDistance(p, p, a, b, s, t);
+		barycentric = Vector3d(1 - t, t, 0);
+		const double distance_ac = EdgeEdgeDistance(p, p, a, c, s, t);
+		if (distance_ac < distance) {
+			distance = distance_ac;
+			barycentric = Vector3d(1 - t, 0, t);
+		}
+		return distance;
+	}
+	const double v = vb / denominator, w = vc / denominator;
+	barycentric = Vector3d(1 - v - w, v, w);
+	return (ap - v * ab - w * ac).norm();
+}
+
+double EdgeEdgeDistance(const Vector3d &p0, const Vector3d &p1, const Vector3d &q0, const Vector3d &q1,
+						double &s, double &t) {
+	// See Real-Time Collision Detection, 5.1.9
+	const Vector3d d1 = p1 - p0, d2 = q1 - q0, r = p0 - q0;
+	const double a = d1.squaredNorm(), e = d2.squaredNorm(), f = d2.dot(r);
+	const double kEpsilon = 1e-20;
+	if (a <= kEpsilon && e <= kEpsilon) {
+		s = t = 0;
+		return r.norm();
+	}
+	if (a <= kEpsilon) {
+		s = 0;
+		t = std::clamp(f / e, 0.0, 1.0);
+	} else {
+		const double c = d1.dot(r);
+		if (e <= kEpsilon) {
+			t = 0;
+			s = std::clamp(-c / a, 0.0, 1.0);
+		} else {
+			const double b = d1.dot(d2);
+			const double denominator = a * e - b * b;
+			s = denominator > 0 ? std::clamp((b * f - c * e) / denominator, 0.0, 1.0) : 0;
+			t = (b * s + f) / e;
+			if (t < 0) {
+				t = 0;
+				s = std::clamp(-c / a, 0.0, 1.0);
+			} else if (t > 1) {
+				t = 1;
+				s = std::clamp((b - c) / a, 0.0, 1.0);
+			}
+		}
+	}
+	return (p0 + s * d1 - q0 - t * d2).norm();
+}
+
+double VertexFaceTOI(const Vector3d &p, const Vector3d &a, const Vector3d &b, const Vector3d &c,
+					 const Vector3d &dp, const Vector3d &da, const Vector3d &db, const Vector3d &dc,
+					 double tolerance, int max_iter, Vector3d &barycentric) {
+	// Any point of the triangle moves no faster than its fastest vertex
+	const double speed = dp.norm() + std::max({da.norm(), db.norm(), dc.norm()});
+	double time = 0;
+	for (int i = 0; i < max_iter; i++) {
+		const double distance = PointTriangleDistance(p + time * dp, a + time * da, b + time * db, c + time * dc, barycentric);
+		if (distance < tolerance) {
+			return time;
+		}
+		if (speed <= 0) {
+			return -1;
+		}
+		time += (distance - tolerance / 2) / speed;
+		if (time > 1) {
+			return -1;
+		}
+	}
+	// Not converged, the time reached is still a lower bound of the impact
+	return time;
+}
+
+double EdgeEdgeTOI(const Vector3d &p0, const Vector3d &p1, const Vector3d &q0, const Vector3d &q1,
+				   const Vector3d &dp0, const Vector3d &dp1, const Vector3d &dq0, const Vector3d &dq1,
+				   double tolerance, int max_iter, double &s, double &t) {
+	const double speed = std::max(dp0.norm(), dp1.norm()) + std::max(dq0.norm(), dq1.norm());
+	double time = 0;
+	for (int i = 0; i < max_iter; i++) {
+		const double distance = EdgeEdgeDistance(p0 + time * dp0, p1 + time * dp1, q0 + time * dq0, q1 + time * dq1, s, t);
+		if (distance < tolerance) {
+			return time;
+		}
+		if (speed <= 0) {
+			return -1;
+		}
+		time += (distance - tolerance / 2) / speed;
+		if (time > 1) {
+			return -1;
+		}
+	}
+	// Not converged, the time reached is still a lower bound of the impact
+	return time;
+}
@@ -0,0 +1,49 @@
+#ifndef FEM_CCD_H
+#define FEM_CCD_H
+
+#include "Util/EigenAll.h"
+
+/**
+ * Closest point on the triangle abc to p
+ * @param barycentric OUTPUT, the closest point is barycentric(0) * a + barycentric(1) * b + barycentric(2) * c
+ * @return the distance
+ */
+double PointTriangleDistance(const Vector3d &p, const Vector3d &a, const Vector3d &b, const Vector3d &c,
+							 Vector3d &barycentric);
+
+/**
+ * Closest points on the segments p0p1 and q0q1
+ * @param s, t OUTPUT, the closest points are (1 - s) p0 + s p1 and (1 - t) q0 + t q1
+ * @return the distance
+ */
+double EdgeEdgeDistance(const Vector3d &p0, const Vector3d &p1, const Vector3d &q0, const Vector3d &q1,
+						double &s, double &t);
+
+/**
+ * Time of impact of a vertex and a triangle moving linearly, found by
+ * conservative advancement. Each iteration advances by the current distance
+ * over an upper bound of the approaching speed, so it never steps past the
+ * impact.
+ * @param p, a, b, c INPUT, positions at the start of the step
+ * @param dp, da, db, dc INPUT, displacements over the step
+ * @param tolerance INPUT, the features are in contact below this distance
+ * @param max_iter INPUT, the impact is reported at the last time reached,
+ * 		  which never passes it, if it has not converged within max_iter
+ * 		  iterations
+ * @param barycentric OUTPUT, closest point on the triangle at the impact
+ * @return the time of impact in [0, 1] relative to the step, or a negative
+ * 		   value if they do not come into contact within the step
+ */
+double VertexFaceTOI(const Vector3d &p, const Vector3d &a, const Vector3d &b, const Vector3d &c,
+					 const Vector3d &dp, const Vector3d &da, const Vector3d &db, const Vector3d &dc,
+					 double tolerance, int max_iter, Vector3d &barycentric);
+
+/**
+ * Time of impact of two edges moving linearly, see VertexFaceTOI
+ * @param s, t OUTPUT, closest points on the edges at the impact
+ */
+double EdgeEdgeTOI(const Vector3d &p0, const Vector3d &p1, const Vector3d &q0, const Vector3d &q1,
+				   const Vector3d &dp0, const Vector3d &dp1, const Vector3d &dq0, const Vector3d &dq1,
+				   double tolerance, int max_iter, double &s, double &t);
+
+#endif //FEM_CCD_H
@@ -0,0 +1,256 @@
+#include "CCDContactGenerator.h"
+#include "CCD/CCD.h"
+#include <algorithm>
+#include <tuple>
+
+DEFINE_CLONE(ContactGeneratorParameter, CCDContactGeneratorParameter)
+DEFINE_ACCESSIBLE_MEMBER(CCDContactGeneratorParameter, double, TimeStep, _time_step)
+DEFINE_ACCESSIBLE_MEMBER(CCDContactGeneratorParameter, double, ContactDistance, _contact_distance)
+DEFINE_ACCESSIBLE_MEMBER(CCDContactGeneratorParameter, int, TOIMaxIter, _toi_max_iter)
+
+namespace {
+	const int kTaskSize = 256;	// number of feature pairs in a narrow phase task
+}
+
+bool CCDContactGenerator::FeaturePair::SameFeatures(const FeaturePair &rhs) const {
+	return _type == rhs._type
+		&& _feature1[0] == rhs._feature1[0] && _feature1[1] == rhs._feature1[1]
+		&& _feature2[0] == rhs._feature2[0] && _feature2[1] == rhs._feature2[1];
+}
+
+bool CCDContactGenerator::FeaturePair::operator<(const FeaturePair &rhs) const {
+	return std::tie(_type, _feature1[0], _feature1[1], _feature2[0], _feature2[1], _face1, _face2)
+		 < std::tie(rhs._type, rhs._feature1[0], rhs._feature1[1], rhs._feature2[0], rhs._feature2[1], rhs._face1, rhs._face2);
+}
+
+void CCDContactGenerator::Initialize(const ContactGeneratorParameter &para) {
+	ContactGenerator::Initialize(para);
+	_time_step = para.GetTimeStep();
+	_max_iter = para.GetTOIMaxIter();
+	_tolerance = para.GetContactDistance();
+}
+
+void CCDContactGenerator::GetContact(const System &system,
+									 vector<ContactPoint> &contact_points) const {
+	contact_points.clear();
+	const auto &objects = system.GetObjects();
+	const int num_objs = objects.size();
+
+	// Sweep the surfaces over the step, the trees are refitted as long as
+	// the topology is kept
+	_start.clear();
+	_end.resize(num_objs);
+	_surface_topos.resize(num_objs);
+	_swept_bvhs.resize(num_objs);
+	_boxes.resize(num_objs);
+	for (int i = 0; i < num_objs; i++) {
+		_start.push_back(objects[i]->GetSurfacePosition());
+		_end[i] = _start[i] + _time_step * objects[i]->GetSurfaceVelocity();
+		const auto& topo = objects[i]->GetSurfaceTopo();
+		const bool same_topo = topo.rows() > 0 && topo.rows() == _surface_topos[i].rows() && topo == _surface_topos[i];
+		if (same_topo) {
+			_swept_bvhs[i].Refit(_start[i], _end[i]);
+		} else {
+			_surface_topos[i] = topo;
+		}
+		if (!same_topo || _swept_bvhs[i].IsDegraded()) {
+			_swept_bvhs[i].Build(_start[i], _end[i], _surface_topos[i]);
+		}
+		_boxes[i] = _swept_bvhs[i].GetBox();
+	}
+
+	// Object level broad phase over the swept boxes
+	_sweep_and_prune.GetPairs(_boxes, _object_pairs);
+	_object_pairs.erase(std::remove_if(_object_pairs.begin(), _object_pairs.end(),
+		[&objects](const std::pair<int, int> &pair) {
+			return !objects[pair.first]->CanCollide(*objects[pair.second]);
+		}), _object_pairs.end());
+
+	// Triangle level broad phase, then the features of the candidate triangles
+	const int num_pairs = _object_pairs.size();
+	_candidates.resize(num_pairs);
+	_feature_pairs.resize(num_pairs);
+	#pragma omp parallel for schedule(dynamic)
+	for (int k = 0; k < num_pairs; k++) {
+		const auto [i1, i2] = _object_pairs[k];
+		_swept_bvhs[i1].Intersect(_swept_bvhs[i2], _candidates[k]);
+		GetFeaturePairs(k);
+	}
+
+	_tasks.clear();
+	for (int k = 0; k < num_pairs; k++) {
+		const int num_features = _feature_pairs[k].size();
+		for (int begin = 0; begin < num_features; begin += kTaskSize) {
+			_tasks.push_back(Task{k, begin, std::min(begin + kTaskSize, num_features)});
+		}
+	}
+	const int num_tasks = _tasks.size();
+	if (static_cast<int>(_task_contacts.size()) < num_tasks) {
+		_task_contacts.resize(num_tasks);
+	}
+
+	#pragma omp parallel for schedule(dynamic)
+	for (int t = 0; t < num_tasks; t++) {
+		const auto& task = _tasks[t];
+		const auto [i1, i2] = _object_pairs[task._pair];
+		auto& contacts = _task_contacts[t];
+		contacts.clear();
+		ContactPoint contact(i1, i2, 0, 0, Vector3d::Zero(), Vector3d::Zero());
+		for (int f = task._begin; f < task._end; f++) {
+			if (TestFeaturePair(i1, i2, _feature_pairs[task._pair][f], contact)) {
+				contacts.push_back(contact);
+			}
+		}
+	}
+
+	// Merge in the order of the tasks, so the result does not depend on the
+	// number of threads
+	for (int t = 0; t < num_tasks; t++) {
+		contact_points.insert(contact_points.end(), _task_contacts[t].begin(), _task_contacts[t].end());
+	}
+	_reduction.Reduce(contact_points);
+}
+
+void CCDContactGenerator::GetFeaturePairs(int k) const {
+	const auto [i1, i2] = _object_pairs[k];
+	const auto& topo1 = _surface_topos[i1];
+	const auto& topo2 = _surface_topos[i2];
+	auto& feature_pairs = _feature_pairs[k];
+	feature_pairs.clear();
+	feature_pairs.reserve(15 * _candidates[k].size());
+	for (const auto& [face1, face2] : _candidates[k]) {
+		for (int j = 0; j < 3; j++) {
+			feature_pairs.push_back(FeaturePair{FeaturePair::kVertexFace, {topo1(face1, j), -1}, {face2, -1}, face1, face2});
+			feature_pairs.push_back(FeaturePair{FeaturePair::kFaceVertex, {face1, -1}, {topo2(face2, j), -1}, face1, face2});
+		}
+		for (int j1 = 0; j1 < 3; j1++) {
+			const int a1 = topo1(face1, j1), b1 = topo1(face1, (j1 + 1) % 3);
+			for (int j2 = 0; j2 < 3; j2++) {
+				const int a2 = topo2(face2, j2), b2 = topo2(face2, (j2 + 1) % 3);
+				feature_pairs.push_back(FeaturePair{
+					FeaturePair::kEdgeEdge,
+					{std::min(a1, b1), std::max(a1, b1)},
+					{std::min(a2, b2), std::max(a2, b2)},
+					face1, face2
+				});
+			}
+		}
+	}
+
+	// A vertex or an edge is shared by several triangles, keep the feature
+	// pair once, reported on the lowest faces
+	std::sort(feature_pairs.begin(), feature_pairs.end());
+	feature_pairs.erase(std::unique(feature_pairs.begin(), feature_pairs.end(),
+		[](const FeaturePair &lhs, const FeaturePair &rhs) {
+			return lhs.SameFeatures(rhs);
+		}), feature_pairs.end());
+}
+
+bool CCDContactGenerator::TestFeaturePair(int i1, int i2, const FeaturePair &features, ContactPoint &contact) const {
+	const auto& start1 = _start[i1];
+	const auto& end1 = _end[i1];
+	const auto& start2 = _start[i2];
+	const auto& end2 = _end[i2];
+	const auto position = [](const auto &vertices, int i) -> Vector3d {
+		return vertices.row(i).transpose();
+	};
+
+	// Closest points as combinations of the vertices of the features
+	int vertices1[3], vertices2[3];
+	double weights1[3] = {0, 0, 0}, weights2[3] = {0, 0, 0};
+	int num1, num2;
+	double toi;
+	Vector3d fallback_normal;	// used when the closest points coincide
+	switch (features._type) {
+		case FeaturePair::kVertexFace:
+		case FeaturePair::kFaceVertex: {
+			const bool vertex_first = features._type == FeaturePair::kVertexFace;
+			const int vertex = vertex_first ? features._feature1[0] : features._feature2[0];
+			const int face = vertex_first ? features._feature2[0] : features._feature1[0];
+			const auto& vertex_start = vertex_first ? start1 : start2;
+			const auto& vertex_end = vertex_first ? end1 : end2;
+			const auto& face_start = vertex_first ? start2 : start1;
+			const auto& face_end = vertex_first ? end2 : end1;
+			const auto& face_topo = vertex_first ? _surface_topos[i2] : _surface_topos[i1];
+			Vector3d p[4], dp[4];
+			int ids[4] = {vertex, face_topo(face, 0), face_topo(face, 1), face_topo(face, 2)};
+			for (int j = 0; j < 4; j++) {
+				const auto& start = j == 0 ? vertex_start : face_start;
+				const auto& end = j == 0 ? vertex_end : face_end;
+				p[j] = position(start, ids[j]);
+				dp[j] = position(end, ids[j]) - p[j];
+			}
+			Vector3d barycentric;
+			toi = VertexFaceTOI(p[0], p[1], p[2], p[3], dp[0], dp[1], dp[2], dp[3], _tolerance, _max_iter, barycentric);
+			if (toi < 0) {
+				return false;
+			}
+			fallback_normal = (p[2] - p[1]).cross(p[3] - p[1]);
+			int* vertex_ids = vertex_first ? vertices1 : vertices2;
+			double* vertex_weights = vertex_first ? weights1 : weights2;
+			int* face_ids = vertex_first ? vertices2 : vertices1;
+			double* face_weights = vertex_first ? weights2 : weights1;
+			vertex_ids[0] = vertex;
+			vertex_weights[0] = 1;
+			for (int j = 0; j < 3; j++) {
+				face_ids[j] = ids[j + 1];
+				face_weights[j] = barycentric(j);
+			}
+			num1 = vertex_first ? 1 : 3;
+			num2 = vertex_first ? 3 : 1;
+			break;
+		}
+		case FeaturePair::kEdgeEdge: {
+			const Vector3d p0 = position(start1, features._feature1[0]), p1 = position(start1, features._feature1[1]);
+			const Vector3d q0 = position(start2, features._feature2[0]), q1 = position(start2, features._feature2[1]);
+			double s, t;
+			toi = EdgeEdgeTOI(p0, p1, q0, q1,
+							  position(end1, features._feature1[0]) - p0, position(end1, features._feature1[1]) - p1,
+							  position(end2, features._feature2[0]) - q0, position(end2, features._feature2[1]) - q1,
+							  _tolerance, _max_iter, s, t);
+			if (toi < 0) {
+				return false;
+			}
+			fallback_normal = (p1 - p0).cross(q1 - q0);
+			vertices1[0] = features._feature1[0];
+			vertices1[1] = features._feature1[1];
+			weights1[0] = 1 - s;
+			weights1[1] = s;
+			vertices2[0] = features._feature2[0];
+			vertices2[1] = features._feature2[1];
+			weights2[0] = 1 - t;
+			weights2[1] = t;
+			num1 = num2 = 2;
+			break;
+		}
+	}
+
+	// The points at the start of the step and at the time of impact
+	Vector3d point1 = Vector3d::Zero(), point2 = Vector3d::Zero();
+	Vector3d displacement1 = Vector3d::Zero(), displacement2 = Vector3d::Zero();
+	for (int j = 0; j < num1; j++) {
+		point1 += weights1[j] * position(start1, vertices1[j]);
+		displacement1 += weights1[j] * (position(end1, vertices1[j]) - position(start1, vertices1[j]));
+	}
+	for (int j = 0; j < num2; j++) {
+		point2 += weights2[j] * position(start2, vertices2[j]);
+		displacement2 += weights2[j] * (position(end2, vertices2[j]) - position(start2, vertices2[j]));
+	}
+	Vector3d normal = point2 + toi * displacement2 - point1 - toi * displacement1;
+	if (normal.norm() < 1e-3 * _tolerance) {
+		// Touching already, orient the face or edge normal against the approach
+		normal = fallback_normal;
+		if (normal.dot(displacement2 - displacement1) > 0) {
+			normal = -normal;
+		}
+	}
+	if (normal.norm() == 0) {
+		return false;
+	}
+
+	contact = ContactPoint(i1, i2, features._face1, features._face2, (point1 + point2) / 2, normal.normalized());
+	contact._gap = std::max(0.0, (point2 - point1).dot(contact._normal));
+	contact._barycentric1 = FaceWeights(_surface_topos[i1].row(features._face1), vertices1, weights1, num1);
+	contact._barycentric2 = FaceWeights(_surface_topos[i2].row(features._face2), vertices2, weights2, num2);
+	return true;
+}
@@ -0,0 +1,89 @@
+#ifndef FEM_CCDCONTACTGENERATOR_H
+#define FEM_CCDCONTACTGENERATOR_H
+
+#include "ContactGenerator.h"
+#include "BVH/BVH.h"
+#include "BroadPhase/SweepAndPrune.h"
+
+class CCDContactGeneratorParameter : public ContactGeneratorParameter {
+public:
+	/**
+	 * @param time_step length of the step the surfaces are swept over
+	 * @param contact_distance features closer than this are in contact
+	 * @param toi_max_iter bounds the iterations of the time of impact search
+	 * @param manifold_size see ContactGeneratorParameter
+	 */
+	CCDContactGeneratorParameter(double time_step, double contact_distance = 1e-4, int toi_max_iter = 100, int manifold_size = 0)
+	: ContactGeneratorParameter(manifold_size) {
+		_time_step = time_step;
+		_contact_distance = contact_distance;
+		_toi_max_iter = toi_max_iter;
+	}
+	DERIVED_DECLARE_CLONE(ContactGeneratorParameter)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(double, TimeStep, _time_step)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(double, ContactDistance, _contact_distance)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(int, TOIMaxIter, _toi_max_iter)
+};
+
+/**
+ * Continuous collision detection. The surfaces are moved linearly over the
+ * step with their current velocities, and every vertex-face and edge-edge
+ * pair of features coming closer than the tolerance within the step is a
+ * contact. The contact is placed at the current position of the features,
+ * with the normal along which they meet and their current separation along
+ * it as the gap, so the velocity level constraint lets them close the gap
+ * within the step but not tunnel through each other.
+ * @note self collisions are not tested
+ */
+class CCDContactGenerator : public ContactGenerator {
+public:
+	void Initialize(const ContactGeneratorParameter &para) override;
+	void GetContact(const System &system, vector<ContactPoint> &contact_points) const override;
+
+protected:
+	struct FeaturePair {
+		enum Type {
+			kVertexFace,	// vertex of object 1 against face of object 2
+			kFaceVertex,	// face of object 1 against vertex of object 2
+			kEdgeEdge
+		} _type;
+		int _feature1[2], _feature2[2];	// vertex id, face id or the two vertex ids of an edge, -1 for unused
+		int _face1, _face2;				// faces the features are reported on
+
+		//-> whether the features are the same, regardless of the faces
+		bool SameFeatures(const FeaturePair &rhs) const;
+		bool operator<(const FeaturePair &rhs) const;
+	};
+
+	//-> collect the feature pairs of the triangle pairs in _candidates[k], without duplicates
+	void GetFeaturePairs(int k) const;
+
+	//-> the contact of a pair of features, if they meet within the step
+	bool TestFeaturePair(int i1, int i2, const FeaturePair &features, ContactPoint &contact) const;
+
+	double _time_step;
+	int _max_iter;
+	double _tolerance;
+
+	// Workspace, one entry per object
+	mutable vector<RowMatrixX3dRef> _start;		// surface vertices at the two ends of the step
+	mutable vector<RowMatrixX3d> _end;
+	mutable vector<Matrix<int, Dynamic, 3>> _surface_topos;	// the topology the swept BVH is built on
+	mutable vector<BVH> _swept_bvhs;			// BVHs over the swept triangles, in world space
+	mutable vector<AABB> _boxes;
+
+	// Workspace of the broad and narrow phase
+	mutable vector<std::pair<int, int>> _object_pairs;
+	mutable vector<vector<std::pair<int, int>>> _candidates;	// candidate triangle pairs of each object pair
+	mutable vector<vector<FeaturePair>> _feature_pairs;		// candidate feature pairs of each object pair
+
+	struct Task {
+		int _pair;			// index into _object_pairs
+		int _begin, _end;	// range of the feature pairs of the pair
+	};
+	mutable vector<Task> _tasks;
+	mutable vector<vector<ContactPoint>> _task_contacts;		// one buffer per task
+	mutable SweepAndPrune _sweep_and_prune;
+};
+
+#endif //FEM_CCDCONTACTGENERATOR_H
@@ -0,0 +1,11 @@
+#include "ConeFrictionModel.h"
+
+DEFINE_CLONE(FrictionModelParameter, ConeFrictionModelParameter)
+
+void ConeFrictionModel::Initialize(const FrictionModelParameter &para) {
+	FrictionModel::Initialize(para);
+	// the two tangent directions of the polygon model, at right angle
+	_num_tangent = 2;
+	_cos = {1, 0};
+	_sin = {0, 1};
+}
@@ -0,0 +1,26 @@
+#ifndef FEM_CONEFRICTIONMODEL_H
+#define FEM_CONEFRICTIONMODEL_H
+
+#include "PolygonFrictionModel.h"
+
+class ConeFrictionModelParameter : public FrictionModelParameter {
+public:
+	/**
+	 * @param stiffness stiffness of the contacts, regularizing the problem,
+	 * 		  0 for rigid contacts
+	 */
+	explicit ConeFrictionModelParameter(double stiffness = 0) : FrictionModelParameter(stiffness) {}
+	DERIVED_DECLARE_CLONE(FrictionModelParameter)
+};
+
+/**
+ * The exact Coulomb cone, ||t|| <= mu * n. Each contact has two orthogonal
+ * tangent rows, whose friction is signed rather than nonnegative, so the
+ * problem is a cone complementarity problem instead of an LCP.
+ */
+class ConeFrictionModel : public PolygonFrictionModel {
+public:
+	void Initialize(const FrictionModelParameter &para) override;
+};
+
+#endif //FEM_CONEFRICTIONMODEL_H
@@ -6,4 +6,25 @@
 #include "Util/Pattern.h"
 
 DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(ContactGeneratorParameter, DCDType, DCDType)
-DEFINE_VIRTUAL_ACCESSIBLE_POINTER_MEMBER(ContactGeneratorParameter, DCDParameter, DCDPara)
\ No newline at end of file
+DEFINE_VIRTUAL_ACCESSIBLE_POINTER_MEMBER(ContactGeneratorParameter, DCDParameter, DCDPara)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(ContactGeneratorParameter, double, CellScale)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(ContactGeneratorParameter, bool, SelfCollision)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(ContactGeneratorParameter, int, CacheSteps)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(ContactGeneratorParameter, double, TimeStep)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(ContactGeneratorParameter, double, ContactDistance)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(ContactGeneratorParameter, int, TOIMaxIter)
+DEFINE_ACCESSIBLE_MEMBER(ContactGeneratorParameter, int, ManifoldSize, _manifold_size)
+DEFINE_ACCESSIBLE_MEMBER(ContactGeneratorParameter, RigidContactType, RigidContact, _rigid_contact)
+
+Vector3d ContactGenerator::FaceWeights(const RowVector3i &face, const int *vertices, const double *weights, int num) {
+	Vector3d face_weights = Vector3d::Zero();
+	for (int j = 0; j < num; j++) {
+		for (int k = 0; k < 3; k++) {
+			if (face[k] == vertices[j]) {
+				face_weights(k) += weights[j];
+				break;
+			}
+		}
+	}
+	return face_weights;
+}
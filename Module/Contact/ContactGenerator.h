@@ -8,20 +8,43 @@
 #include "Util/EigenAll.h"
 #include "System/System.h"
 #include "DCD/DCD.h"
+#include "ContactReduction.h"
 
 enum class ContactGeneratorType {
 	kDCD,
-	kCCD
+	kCCD,
+	kSpatialHash
+};
+
+// How deformable objects are tested against rigid ones with a signed distance
+enum class RigidContactType {
+	kTriangle,	// triangle against triangle, as any other pair
+	kAnalytic	// surface vertices and edges against the signed distance, closed form or baked
 };
 
 class ContactGeneratorParameter {
 public:
-	ContactGeneratorParameter() = default;
+	/**
+	 * @param manifold_size the most contacts kept of each cluster of an
+	 * 		  object pair, 0 keeps every contact, see ContactReduction
+	 * @param rigid_contact see RigidContactType, only the DCD based
+	 * 		  generators support kAnalytic
+	 */
+	explicit ContactGeneratorParameter(int manifold_size = 0, RigidContactType rigid_contact = RigidContactType::kTriangle)
+	: _manifold_size(manifold_size), _rigid_contact(rigid_contact) {}
 	virtual ~ContactGeneratorParameter() = default;
 	BASE_DECLARE_CLONE(ContactGeneratorParameter)
 
 	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(DCDType, DCDType)
 	DECLARE_VIRTUAL_ACCESSIBLE_POINTER_MEMBER(DCDParameter, DCDPara)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(double, CellScale)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(bool, SelfCollision)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(int, CacheSteps)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(double, TimeStep)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(double, ContactDistance)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(int, TOIMaxIter)
+	DECLARE_ACCESSIBLE_MEMBER(int, ManifoldSize, _manifold_size)
+	DECLARE_ACCESSIBLE_MEMBER(RigidContactType, RigidContact, _rigid_contact)
 };
 
 struct ContactPoint {
@@ -32,15 +55,22 @@ struct ContactPoint {
 			  _idx1(idx1), _idx2(idx2),
 			  _point(point), _normal(normal) {}
 
-	int _obj1, _obj2;	// The ids of the colliding objects
-	int _idx1, _idx2;	// The ids of colliding primitives on the two surfaces
+	int _obj1, _obj2;	// The ids of the colliding objects, equal for self contacts
+	int _idx1, _idx2;	// The ids of colliding primitives on the two surfaces, -1 for a signed distance
 	Vector3d _point;	// The colliding points
+	Vector3d _barycentric1 = Vector3d::Zero();	// Weights on the vertices of the faces _idx1 and _idx2 of the
+	Vector3d _barycentric2 = Vector3d::Zero();	// points on the surfaces, zero for a signed distance
 	Vector3d _normal;	// Normal points from 1 to 2
+	double _weight = 1;	// Scale of the rows of the Jacobian, for contacts standing for reduced ones
+	double _depth = 0;	// Penetration depth along the normal, only known for the analytic contacts
+	double _gap = 0;	// Separation along the normal of the speculative contacts, closed within the step
 };
 
 class ContactGenerator {
 public:
-	virtual void Initialize(const ContactGeneratorParameter &para) {}
+	virtual void Initialize(const ContactGeneratorParameter &para) {
+		_reduction.Initialize(para.GetManifoldSize());
+	}
 
 	/**
 	 * @param system INPUT, the physics systems
@@ -50,7 +80,22 @@ public:
 	GetContact(const System &system,
 			   vector<ContactPoint> &contact_points) const = 0;
 
+	//-> whether GetContact reads the BVHs of the objects, which then have to be refit every step
+	virtual bool UsesBVH() const {
+		return false;
+	}
+
 	virtual ~ContactGenerator() = default;
+
+protected:
+	/**
+	 * Weights on the vertices of a face of a combination of some of them
+	 * @param face INPUT, the vertices of the face
+	 * @param vertices, weights INPUT, the combination, num vertices of the face and their weights
+	 */
+	static Vector3d FaceWeights(const RowVector3i &face, const int *vertices, const double *weights, int num);
+
+	ContactReduction _reduction;	// applied to the contacts at the end of GetContact
 };
 
 #endif //FEM_CONTACTGENERATOR_H
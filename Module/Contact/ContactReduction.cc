@@ -0,0 +1,257 @@
+#include "ContactReduction.h"
+#include "ContactGenerator.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace {
+	const double kCosNormalTolerance = 0.95;	// contacts with normals closer than this are clustered together
+	const double kPatchSpacing = 3;				// contacts closer than this times their average spacing are in a patch
+}
+
+void ContactReduction::Initialize(int max_points) {
+	_max_points = max_points;
+}
+
+void ContactReduction::Reduce(std::vector<ContactPoint> &contacts) const {
+	const int num_contacts = contacts.size();
+	if (_max_points <= 0 || num_contacts <= _max_points) {
+		return;
+	}
+
+	_order.resize(num_contacts);
+	for (int i = 0; i < num_contacts; i++) {
+		_order[i] = i;
+	}
+	std::stable_sort(_order.begin(), _order.end(), [&contacts](int lhs, int rhs) {
+		return std::make_pair(contacts[lhs]._obj1, contacts[lhs]._obj2) < std::make_pair(contacts[rhs]._obj1, contacts[rhs]._obj2);
+	});
+	_is_kept.assign(num_contacts, false);
+
+	for (int begin = 0, end = 0; begin < num_contacts; begin = end) {
+		const auto& first = contacts[_order[begin]];
+		for (end = begin; end < num_contacts; end++) {
+			const auto& contact = contacts[_order[end]];
+			if (contact._obj1 != first._obj1 || contact._obj2 != first._obj2) {
+				break;
+			}
+		}
+
+		// Cluster the contacts of the pair by their normals
+		_seeds.clear();
+		_cluster_ids.resize(end - begin);
+		for (int i = begin; i < end; i++) {
+			const Vector3d& normal = contacts[_order[i]]._normal;
+			const int num_seeds = _seeds.size();
+			int id = 0;
+			while (id < num_seeds && normal.dot(contacts[_seeds[id]]._normal) < kCosNormalTolerance) {
+				id++;
+			}
+			if (id == num_seeds) {
+				_seeds.push_back(_order[i]);
+			}
+			_cluster_ids[i - begin] = id;
+		}
+
+		const int num_clusters = _seeds.size();
+		for (int id = 0; id < num_clusters; id++) {
+			_group.clear();
+			for (int i = begin; i < end; i++) {
+				if (_cluster_ids[i - begin] == id) {
+					_group.push_back(_order[i]);
+				}
+			}
+			const int group_size = _group.size();
+			if (group_size <= _max_points) {
+				for (int c : _group) {
+					_is_kept[c] = true;
+				}
+				continue;
+			}
+
+			// Parallel but separated patches are reduced on their own
+			const int num_patches = Split(contacts);
+			for (int patch = 0; patch < num_patches; patch++) {
+				_cluster.clear();
+				Vector3d normal = Vector3d::Zero();
+				for (int i = 0; i < group_size; i++) {
+					if (_patch_ids[i] == patch) {
+						_cluster.push_back(_group[i]);
+						normal += contacts[_group[i]]._normal;
+					}
+				}
+				const int cluster_size = _cluster.size();
+				if (cluster_size <= _max_points) {
+					for (int c : _cluster) {
+						_is_kept[c] = true;
+					}
+					continue;
+				}
+				normal = normal.norm() > 0 ? Vector3d(normal.normalized()) : contacts[_cluster[0]]._normal;
+				Select(contacts, normal);
+
+				// Each kept contact stands for cluster_size / num_kept of them,
+				// and the LCP scales with the square of the Jacobian rows
+				const double weight = std::sqrt(static_cast<double>(cluster_size) / _kept.size());
+				for (int c : _kept) {
+					contacts[c]._normal = normal;
+					contacts[c]._weight *= weight;
+					_is_kept[c] = true;
+				}
+			}
+		}
+	}
+
+	int num_kept = 0;
+	for (int i = 0; i < num_contacts; i++) {
+		if (_is_kept[i]) {
+			contacts[num_kept++] = contacts[i];
+		}
+	}
+	contacts.erase(contacts.begin() + num_kept, contacts.end());
+}
+
+int ContactReduction::Split(const std::vector<ContactPoint> &contacts) const {
+	const int group_size = _group.size();
+	const auto point = [&](int i) -> const Vector3d& {
+		return contacts[_group[i]]._point;
+	};
+	_sweep.resize(group_size);
+	for (int i = 0; i < group_size; i++) {
+		_sweep[i] = i;
+	}
+	std::sort(_sweep.begin(), _sweep.end(), [&point](int lhs, int rhs) {
+		return std::make_pair(point(lhs).x(), lhs) < std::make_pair(point(rhs).x(), rhs);
+	});
+
+	// The spacing of the contacts, the distance to the nearest one averaged,
+	// which is searched for along the sweep as long as it can be closer
+	double spacing = 0;
+	for (int k = 0; k < group_size; k++) {
+		const Vector3d& p = point(_sweep[k]);
+		double nearest = std::numeric_limits<double>::max();
+		for (int l = k + 1; l < group_size && point(_sweep[l]).x() - p.x() < nearest; l++) {
+			nearest = std::min(nearest, (point(_sweep[l]) - p).norm());
+		}
+		for (int l = k - 1; l >= 0 && p.x() - point(_sweep[l]).x() < nearest; l--) {
+			nearest = std::min(nearest, (point(_sweep[l]) - p).norm());
+		}
+		spacing += nearest;
+	}
+	const double radius = kPatchSpacing * spacing / group_size;
+
+	// Link the contacts closer than the radius, each patch being rooted at
+	// its first contact
+	_parents.resize(group_size);
+	for (int i = 0; i < group_size; i++) {
+		_parents[i] = i;
+	}
+	const auto find = [this](int i) {
+		while (_parents[i] != i) {
+			_parents[i] = _parents[_parents[i]];
+			i = _parents[i];
+		}
+		return i;
+	};
+	for (int k = 0; k < group_size; k++) {
+		const Vector3d& p = point(_sweep[k]);
+		for (int l = k + 1; l < group_size && point(_sweep[l]).x() - p.x() <= radius; l++) {
+			if ((point(_sweep[l]) - p).norm() <= radius) {
+				const int root1 = find(_sweep[k]), root2 = find(_sweep[l]);
+				_parents[std::max(root1, root2)] = std::min(root1, root2);
+			}
+		}
+	}
+
+	int num_patches = 0;
+	_patch_ids.resize(group_size);
+	for (int i = 0; i < group_size; i++) {
+		const int root = find(i);
+		_patch_ids[i] = root == i ? num_patches++ : _patch_ids[root];
+	}
+	return num_patches;
+}
+
+void ContactReduction::Select(const std::vector<ContactPoint> &contacts, const Vector3d &normal) const {
+	const int cluster_size = _cluster.size();
+	const auto projected = [&](int i) -> Vector3d {
+		const Vector3d& point = contacts[_cluster[i]]._point;
+		return point - point.dot(normal) * normal;
+	};
+
+	Vector3d center = Vector3d::Zero();
+	for (int i = 0; i < cluster_size; i++) {
+		center += projected(i);
+	}
+	center /= cluster_size;
+
+	_kept.clear();
+	_distances.assign(cluster_size, std::numeric_limits<double>::max());
+	const auto keep = [&](int k) {
+		_kept.push_back(_cluster[k]);
+		const Vector3d point = projected(k);
+		for (int i = 0; i < cluster_size; i++) {
+			_distances[i] = std::min(_distances[i], (projected(i) - point).norm());
+		}
+	};
+	// the first of the largest, so the choice is deterministic
+	const auto argmax = [cluster_size](const auto &score) {
+		int best = 0;
+		double best_score = score(0);
+		for (int i = 1; i < cluster_size; i++) {
+			const double current = score(i);
+			if (current > best_score) {
+				best = i;
+				best_score = current;
+			}
+		}
+		return std::make_pair(best, best_score);
+	};
+
+	// The deepest one, or the one farthest from the center if they are all
+	// as deep, and the one farthest from it
+	const auto depth = [&](int i) {
+		const auto& contact = contacts[_cluster[i]];
+		return contact._depth - contact._gap;
+	};
+	const auto deepest = argmax(depth);
+	const auto shallowest = argmax([&](int i) {
+		return -depth(i);
+	});
+	const int first = deepest.second > -shallowest.second ? deepest.first : argmax([&](int i) {
+		return (projected(i) - center).norm();
+	}).first;
+	keep(first);
+	auto [second, distance] = argmax([&](int i) {
+		return _distances[i];
+	});
+	if (distance <= 0) {
+		return;
+	}
+	keep(second);
+
+	// The one spanning the largest triangle with them
+	if (_max_points >= 3) {
+		const Vector3d origin = projected(first), edge = projected(second) - origin;
+		const auto [third, area] = argmax([&](int i) {
+			return (projected(i) - origin).cross(edge).norm();
+		});
+		if (area > 0) {
+			keep(third);
+		}
+	}
+
+	// Then spread the rest over the area
+	int num_kept = _kept.size();
+	while (num_kept < _max_points) {
+		const auto [next, distance] = argmax([&](int i) {
+			return _distances[i];
+		});
+		if (distance <= 0) {
+			break;
+		}
+		keep(next);
+		num_kept++;
+	}
+	std::sort(_kept.begin(), _kept.end());
+}
@@ -0,0 +1,57 @@
+#ifndef FEM_CONTACTREDUCTION_H
+#define FEM_CONTACTREDUCTION_H
+
+#include "Util/EigenAll.h"
+#include <vector>
+
+struct ContactPoint;
+
+/**
+ * Reduce the contacts of each object pair to a bounded manifold. The
+ * contacts of a pair are clustered by their normals, and then split into
+ * patches, contacts closer than a few times their average spacing being in
+ * the same patch. A patch with more than max_points contacts keeps only
+ * max_points of them: the deepest one, or the one farthest from the center
+ * if they are all as deep, the one farthest from it, the one farthest from
+ * the line through them, and then each time the one farthest from those
+ * kept. The kept contacts share the average normal of the patch, and their
+ * rows of the Jacobian are weighted so the patch is as stiff as before.
+ */
+class ContactReduction {
+public:
+	/**
+	 * @param max_points INPUT, the most contacts kept of a cluster, 4 to 16
+	 * 		  is enough for most contacts, 0 keeps every contact
+	 */
+	void Initialize(int max_points);
+
+	/**
+	 * @param contacts INPUT/OUTPUT, the contacts to be reduced, the order of
+	 * 		  the kept ones is preserved
+	 */
+	void Reduce(std::vector<ContactPoint> &contacts) const;
+
+protected:
+	//-> split _group into patches, returns their number and fills _patch_ids
+	int Split(const std::vector<ContactPoint> &contacts) const;
+
+	//-> choose the contacts to keep from _cluster, into _kept
+	void Select(const std::vector<ContactPoint> &contacts, const Vector3d &normal) const;
+
+	int _max_points = 0;
+
+	// Workspace
+	mutable std::vector<int> _order;			// contacts sorted by object pair
+	mutable std::vector<int> _seeds;			// first contact of each cluster
+	mutable std::vector<int> _cluster_ids;		// cluster of each contact of the pair
+	mutable std::vector<int> _group;			// contacts of the cluster being split
+	mutable std::vector<int> _sweep;			// _group sorted along x
+	mutable std::vector<int> _parents;			// union find over _group
+	mutable std::vector<int> _patch_ids;		// patch of each contact of _group
+	mutable std::vector<int> _cluster;			// contacts of the patch being reduced
+	mutable std::vector<int> _kept;
+	mutable std::vector<double> _distances;		// distance to the nearest kept contact
+	mutable std::vector<char> _is_kept;
+};
+
+#endif //FEM_CONTACTREDUCTION_H
@@ -11,4 +11,41 @@ DEFINE_ACCESSIBLE_MEMBER(DCDParameter, double, Tolerance, _tolerance)
 void DCD::Initialize(const DCDParameter &para) {
 	_max_iter = para.GetMaxIter();
 	_tolerance = para.GetTolerance();
-}
\ No newline at end of file
+}
+
+void DCD::GetIntersected(const TrianglePairBatch &batch, std::vector<int> &hits,
+						 std::vector<Vector3d> &points, std::vector<Vector3d> &normals) const {
+	hits.clear();
+	points.clear();
+	normals.clear();
+	const int size = batch.Size();
+	for (int i = 0; i < size; i++) {
+		Vector3d point, normal;
+		if (GetIntersected(batch.GetFirst(i, 0), batch.GetFirst(i, 1), batch.GetFirst(i, 2),
+						   batch.GetSecond(i, 0), batch.GetSecond(i, 1), batch.GetSecond(i, 2),
+						   point, normal)) {
+			hits.push_back(i);
+			points.push_back(point);
+			normals.push_back(normal);
+		}
+	}
+}
+
+void TrianglePairBatch::Resize(int size) {
+	for (int k = 0; k < 9; k++) {
+		_first[k].resize(size);
+		_second[k].resize(size);
+	}
+}
+
+int TrianglePairBatch::Size() const {
+	return _first[0].size();
+}
+
+Vector3d TrianglePairBatch::GetFirst(int i, int v) const {
+	return {_first[3 * v][i], _first[3 * v + 1][i], _first[3 * v + 2][i]};
+}
+
+Vector3d TrianglePairBatch::GetSecond(int i, int v) const {
+	return {_second[3 * v][i], _second[3 * v + 1][i], _second[3 * v + 2][i]};
+}
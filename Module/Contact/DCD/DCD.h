@@ -7,6 +7,8 @@
 
 #include "Util/EigenAll.h"
 #include "Util/Pattern.h"
+#include <array>
+#include <vector>
 
 enum class DCDType {
 	kFast
@@ -21,6 +23,36 @@ public:
 
 };
 
+/**
+ * Triangle pairs in structure of arrays layout, _first[3 * v + c][i] is the
+ * cth coordinate of the vth vertex of the first triangle of the ith pair,
+ * and likewise for _second, so a batched test reads consecutive pairs with
+ * contiguous loads
+ */
+struct TrianglePairBatch {
+	void Resize(int size);
+	int Size() const;
+
+	//-> set the vth vertex of the first / second triangle of the ith pair
+	template<class Derived>
+	void SetFirst(int i, int v, const Eigen::MatrixBase<Derived> &vertex) {
+		for (int c = 0; c < 3; c++) {
+			_first[3 * v + c][i] = vertex(c);
+		}
+	}
+	template<class Derived>
+	void SetSecond(int i, int v, const Eigen::MatrixBase<Derived> &vertex) {
+		for (int c = 0; c < 3; c++) {
+			_second[3 * v + c][i] = vertex(c);
+		}
+	}
+
+	Vector3d GetFirst(int i, int v) const;
+	Vector3d GetSecond(int i, int v) const;
+
+	std::array<std::vector<double>, 9> _first, _second;
+};
+
 class DCD {
 public:
 	virtual void Initialize(const DCDParameter& para) = 0;
@@ -36,11 +68,24 @@ public:
 	 *       in that case, the normal is chosen as the normal of
 	 *       either surface.
 	 * @return whether there is an intersection
+	 * @note called concurrently by the contact generators
 	 */
 	virtual bool GetIntersected(
 			Vector3d A1, Vector3d B1, Vector3d C1,
 			Vector3d A2, Vector3d B2, Vector3d C2,
-			Vector3d &point, Vector3d &normal) = 0;
+			Vector3d &point, Vector3d &normal) const = 0;
+
+	/**
+	 * Batched version of the above, by default a loop over the pairs
+	 * @param batch INPUT, the triangle pairs to be tested
+	 * @param hits OUTPUT, it will be cleared and loaded with the indices of
+	 * 		  the intersecting pairs, ascending
+	 * @param points, normals OUTPUT, they will be cleared and loaded with the
+	 * 		  intersection point and normal of each hit
+	 * @note called concurrently by the contact generators
+	 */
+	virtual void GetIntersected(const TrianglePairBatch &batch, std::vector<int> &hits,
+								std::vector<Vector3d> &points, std::vector<Vector3d> &normals) const;
 
 	virtual ~DCD() = default;
 
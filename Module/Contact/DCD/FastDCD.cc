@@ -4,6 +4,43 @@
 
 #include "FastDCD.h"
 #include "tritritest.h"
+#include <algorithm>
+
+namespace {
+	const int kLanes = 8;	// pairs in a block of the rejection test
+
+	/**
+	 * Whether all the vertices of one triangle lie strictly on one side of
+	 * the plane of the other, for the pairs [begin, begin + count), told by
+	 * a positive separation. The plane has the normal (V[a] - V[o]) x (V[b] - V[o])
+	 * and passes V[p], V being the vertices of plane_tri. The arithmetic is
+	 * the one of tri_tri_intersection_test_3d, so both reject the same pairs,
+	 * NaN coordinates aside.
+	 */
+	void PlaneSideTest(const std::array<std::vector<double>, 9> &plane_tri, int a, int b, int o, int p,
+					   const std::array<std::vector<double>, 9> &tri, int begin, int count, double separation[kLanes]) {
+		const double *ax = plane_tri[3 * a].data() + begin, *ay = plane_tri[3 * a + 1].data() + begin, *az = plane_tri[3 * a + 2].data() + begin;
+		const double *bx = plane_tri[3 * b].data() + begin, *by = plane_tri[3 * b + 1].data() + begin, *bz = plane_tri[3 * b + 2].data() + begin;
+		const double *ox = plane_tri[3 * o].data() + begin, *oy = plane_tri[3 * o + 1].data() + begin, *oz = plane_tri[3 * o + 2].data() + begin;
+		const double *px = plane_tri[3 * p].data() + begin, *py = plane_tri[3 * p + 1].data() + begin, *pz = plane_tri[3 * p + 2].data() + begin;
+		const double *x0 = tri[0].data() + begin, *y0 = tri[1].data() + begin, *z0 = tri[2].data() + begin;
+		const double *x1 = tri[3].data() + begin, *y1 = tri[4].data() + begin, *z1 = tri[5].data() + begin;
+		const double *x2 = tri[6].data() + begin, *y2 = tri[7].data() + begin, *z2 = tri[8].data() + begin;
+
+		#pragma omp simd
+		for (int l = 0; l < count; l++) {
+			const double v1x = ax[l] - ox[l], v1y = ay[l] - oy[l], v1z = az[l] - oz[l];
+			const double v2x = bx[l] - ox[l], v2y = by[l] - oy[l], v2z = bz[l] - oz[l];
+			const double nx = v1y * v2z - v1z * v2y;
+			const double ny = v1z * v2x - v1x * v2z;
+			const double nz = v1x * v2y - v1y * v2x;
+			const double d0 = (x0[l] - px[l]) * nx + (y0[l] - py[l]) * ny + (z0[l] - pz[l]) * nz;
+			const double d1 = (x1[l] - px[l]) * nx + (y1[l] - py[l]) * ny + (z1[l] - pz[l]) * nz;
+			const double d2 = (x2[l] - px[l]) * nx + (y2[l] - py[l]) * ny + (z2[l] - pz[l]) * nz;
+			separation[l] = std::min(d0 * d1, d0 * d2);		// a min instruction, not a branch
+		}
+	}
+}
 
 void FastDCD::Initialize(const DCDParameter &para) {
 	DCD::Initialize(para);
@@ -11,7 +48,7 @@ void FastDCD::Initialize(const DCDParameter &para) {
 
 bool FastDCD::GetIntersected(Vector3d A1, Vector3d B1, Vector3d C1, Vector3d A2,
 							 Vector3d B2, Vector3d C2, Vector3d &point,
-							 Vector3d &normal) {
+							 Vector3d &normal) const {
 	int coplanar = 0;
 	real end_point1[3], end_point2[3];
 	real tri1[3][3], tri2[3][3];
@@ -47,4 +84,51 @@ bool FastDCD::GetIntersected(Vector3d A1, Vector3d B1, Vector3d C1, Vector3d A2,
 	} else {
 		return false;
 	}
-}
\ No newline at end of file
+}
+
+void FastDCD::GetIntersected(const TrianglePairBatch &batch, std::vector<int> &hits,
+							 std::vector<Vector3d> &points, std::vector<Vector3d> &normals) const {
+	hits.clear();
+	points.clear();
+	normals.clear();
+	const int size = batch.Size();
+
+	// Rejection by the plane of the second triangle, then by the one of the
+	// first, the survivors are compacted into hits
+	for (int begin = 0; begin < size; begin += kLanes) {
+		const int count = std::min(kLanes, size - begin);
+		double separation1[kLanes], separation2[kLanes];
+		PlaneSideTest(batch._second, 0, 1, 2, 2, batch._first, begin, count, separation1);
+		PlaneSideTest(batch._first, 1, 2, 0, 2, batch._second, begin, count, separation2);
+		for (int l = 0; l < count; l++) {
+			if (!(separation1[l] > 0) && !(separation2[l] > 0)) {
+				hits.push_back(begin + l);
+			}
+		}
+	}
+
+	// Full test of the survivors, compacting the hits in place
+	const int num_survivors = hits.size();
+	int num_hits = 0;
+	for (int s = 0; s < num_survivors; s++) {
+		const int i = hits[s];
+		int coplanar = 0;
+		real end_point1[3], end_point2[3];
+		real tri1[3][3], tri2[3][3];
+		for (int v = 0; v < 3; v++) {
+			for (int c = 0; c < 3; c++) {
+				tri1[v][c] = batch._first[3 * v + c][i];
+				tri2[v][c] = batch._second[3 * v + c][i];
+			}
+		}
+		if (tri_tri_intersection_test_3d(tri1[0], tri1[1], tri1[2],
+										 tri2[0], tri2[1], tri2[2],
+										 &coplanar, end_point1, end_point2)) {
+			hits[num_hits++] = i;
+			points.emplace_back(end_point1[0], end_point1[1], end_point1[2]);
+			const Vector3d A1 = batch.GetFirst(i, 0);
+			normals.push_back((batch.GetFirst(i, 1) - A1).cross(batch.GetFirst(i, 2) - A1).normalized());
+		}
+	}
+	hits.resize(num_hits);
+}
@@ -12,7 +12,16 @@ class FastDCD : public DCD {
 
 	bool GetIntersected(Vector3d A1, Vector3d B1, Vector3d C1, Vector3d A2,
 						Vector3d B2, Vector3d C2, Vector3d &point,
-						Vector3d &normal) override;
+						Vector3d &normal) const override;
+
+	/**
+	 * The batch is rejected kLanes pairs at a time by the plane side tests
+	 * the scalar routine starts with, written branch free over the lanes so
+	 * the compiler vectorizes them, and only the survivors are passed on to
+	 * the full test computing the intersection segment
+	 */
+	void GetIntersected(const TrianglePairBatch &batch, std::vector<int> &hits,
+						std::vector<Vector3d> &points, std::vector<Vector3d> &normals) const override;
 };
 
 #endif //FEM_FASTDCD_H
@@ -3,16 +3,33 @@
 //
 
 #include "DCDContactGenerator.h"
+#include "CCD/CCD.h"
 #include "Util/Pattern.h"
 #include "Util/Factory.h"
+#include <algorithm>
+#include <limits>
+#include <omp.h>
 
 DEFINE_ACCESSIBLE_MEMBER(DCDContactGeneratorParameter, DCDType, DCDType, _dcd_type)
 DEFINE_ACCESSIBLE_POINTER_MEMBER(DCDContactGeneratorParameter, DCDParameter, DCDPara, _dcd_parameter)
+DEFINE_ACCESSIBLE_MEMBER(DCDContactGeneratorParameter, bool, SelfCollision, _self_collision)
+DEFINE_ACCESSIBLE_MEMBER(DCDContactGeneratorParameter, int, CacheSteps, _cache_steps)
 DEFINE_CLONE(ContactGeneratorParameter, DCDContactGeneratorParameter)
 
+namespace {
+	const int kTaskSize = 256;	// number of candidate triangle pairs in a narrow phase task
+	const int kEdgeIterations = 24;	// golden section steps for the deepest point of an edge
+	const double kGoldenRatio = 0.6180339887498949;
+	const double kInfinity = std::numeric_limits<double>::infinity();
+}
+
 void DCDContactGenerator::Initialize(const ContactGeneratorParameter &para) {
+	ContactGenerator::Initialize(para);
 	_dcd = DCDFactory::GetInstance()->GetDCD(para.GetDCDType());
 	_dcd->Initialize(*para.GetDCDPara());
+	_self_collision = para.GetSelfCollision();
+	_rigid_contact = para.GetRigidContact();
+	_cache_steps = para.GetCacheSteps();
 }
 
 void DCDContactGenerator::GetContact(const System &system,
@@ -20,39 +37,304 @@ void DCDContactGenerator::GetContact(const System &system,
 	contact_points.clear();
 	const auto &objects = system.GetObjects();
 	const int num_objs = objects.size();
-	for (int i1 = 0; i1 < num_objs; i1++) {
-		const auto &object1 = objects[i1];
-		const auto &surface_vertices1 = object1->GetSurfacePosition();
-		const auto &surface_topo1 = object1->GetSurfaceTopo();
-		for (int i2 = 0; i2 < i1; i2++) {
-			const auto &object2 = objects[i2];
-			const auto &surface_vertices2 = object2->GetSurfacePosition();
-			const auto &surface_topo2 = object2->GetSurfaceTopo();
-
-			int num_face1 = surface_topo1.rows(),
-				num_face2 = surface_topo2.rows();
-			for (int face_id1 = 0; face_id1 < num_face1; face_id1++) {
-				for (int face_id2 = 0; face_id2 < num_face2; face_id2++) {
-					Vector3d point, normal;
-					const auto& face_elements_id1 = surface_topo1.row(face_id1);
-					const auto& face_elements_id2 = surface_topo2.row(face_id2);
-					bool intersected = _dcd->GetIntersected(
-						surface_vertices1.row(face_elements_id1(0)),
-						surface_vertices1.row(face_elements_id1(1)),
-						surface_vertices1.row(face_elements_id1(2)),
-						surface_vertices2.row(face_elements_id2(0)),
-						surface_vertices2.row(face_elements_id2(1)),
-						surface_vertices2.row(face_elements_id2(2)),
-						point, normal);
-					if (intersected) {
-						contact_points.push_back(ContactPoint(
-							i1, i2,
-							face_id1, face_id2,
-							point, normal
-						));
-					}
+
+	_surface_vertices.clear();
+	_surface_topos.clear();
+	_rotations.resize(num_objs);
+	_translations.resize(num_objs);
+	_boxes.resize(num_objs);
+	for (int i = 0; i < num_objs; i++) {
+		_surface_vertices.push_back(objects[i]->GetSurfacePosition());
+		_surface_topos.push_back(objects[i]->GetSurfaceTopo());
+		objects[i]->GetBVHFrame(_rotations[i], _translations[i]);
+		_boxes[i] = objects[i]->GetBVH().GetBox().Transformed(_rotations[i], _translations[i]);
+	}
+
+	GetRoles(objects);
+	if (!IsCacheValid()) {
+		BroadPhase(objects);
+	}
+
+	// The self collision candidates are found every step
+	const int num_pairs = _object_pairs.size();
+	#pragma omp parallel for schedule(dynamic)
+	for (int k = 0; k < num_pairs; k++) {
+		const auto [i1, i2] = _object_pairs[k];
+		if (i1 == i2) {
+			objects[i1]->GetBVH().SelfIntersect(_candidates[k]);
+		}
+	}
+
+	NarrowPhase(contact_points);
+	AnalyticPhase(objects, contact_points);
+	_reduction.Reduce(contact_points);
+}
+
+void DCDContactGenerator::BroadPhase(const vector<Object*> &objects) const {
+	const int num_objs = objects.size();
+
+	// Object level broad phase
+	_inflated_boxes.resize(num_objs);
+	for (int i = 0; i < num_objs; i++) {
+		_inflated_boxes[i] = _boxes[i].Inflated(_margin);
+	}
+	_sweep_and_prune.GetPairs(_inflated_boxes, _object_pairs);
+	_object_pairs.erase(std::remove_if(_object_pairs.begin(), _object_pairs.end(),
+		[&objects](const std::pair<int, int> &pair) {
+			return !objects[pair.first]->CanCollide(*objects[pair.second]);
+		}), _object_pairs.end());
+
+	// Pairs of a deformable object and one with a signed distance skip the triangles
+	_analytic_pairs.clear();
+	int num_kept = 0;
+	for (const auto& pair : _object_pairs) {
+		if (IsAnalytic(pair.first, pair.second)) {
+			_analytic_pairs.push_back(_roles[pair.first] == kDistance ? pair : std::make_pair(pair.second, pair.first));
+		} else {
+			_object_pairs[num_kept++] = pair;
+		}
+	}
+	_object_pairs.resize(num_kept);
+
+	if (_self_collision) {
+		for (int i = 0; i < num_objs; i++) {
+			if (objects[i]->IsDeformable()) {
+				_object_pairs.emplace_back(i, i);
+			}
+		}
+		std::sort(_object_pairs.begin(), _object_pairs.end());
+	}
+
+	// Triangle level broad phase, only the ones with overlapping boxes are
+	// tested, in the frame of the BVH of object i1
+	const int num_pairs = _object_pairs.size();
+	_candidates.resize(num_pairs);
+	#pragma omp parallel for schedule(dynamic)
+	for (int k = 0; k < num_pairs; k++) {
+		const auto [i1, i2] = _object_pairs[k];
+		if (i1 == i2) {
+			continue;
+		}
+		const Matrix3d rotation = _rotations[i1].transpose() * _rotations[i2];
+		const Vector3d translation = _rotations[i1].transpose() * (_translations[i2] - _translations[i1]);
+		objects[i1]->GetBVH().Intersect(objects[i2]->GetBVH(), rotation, translation, _candidates[k], 2 * _margin);
+	}
+}
+
+bool DCDContactGenerator::IsCacheValid() const {
+	if (_cache_steps == 0) {
+		return false;
+	}
+	const int num_objs = _surface_vertices.size();
+	bool same_surfaces = static_cast<int>(_cached_surfaces.size()) == num_objs && static_cast<int>(_last_surfaces.size()) == num_objs;
+	for (int i = 0; same_surfaces && i < num_objs; i++) {
+		same_surfaces = _cached_surfaces[i].rows() == _surface_vertices[i].rows()
+						&& _last_surfaces[i].rows() == _surface_vertices[i].rows();
+	}
+
+	// The farthest any surface vertex has moved since the candidates were
+	// found, and in the last step
+	double drift = 0, step = 0;
+	for (int i = 0; same_surfaces && i < num_objs; i++) {
+		if (_surface_vertices[i].rows() > 0) {
+			drift = std::max(drift, (_surface_vertices[i] - _cached_surfaces[i]).rowwise().norm().maxCoeff());
+			step = std::max(step, (_surface_vertices[i] - _last_surfaces[i]).rowwise().norm().maxCoeff());
+		}
+	}
+	_last_surfaces.resize(num_objs);
+	for (int i = 0; i < num_objs; i++) {
+		_last_surfaces[i] = _surface_vertices[i];
+	}
+
+	if (same_surfaces && drift <= _margin) {
+		return true;
+	}
+	_margin = _cache_steps * step;
+	_cached_surfaces = _last_surfaces;
+	return false;
+}
+
+void DCDContactGenerator::NarrowPhase(vector<ContactPoint> &contact_points) const {
+	const int num_pairs = _object_pairs.size();
+
+	// Split into tasks of consecutive candidates of an object pair, each
+	// writing into its own buffer
+	_tasks.clear();
+	for (int k = 0; k < num_pairs; k++) {
+		const int num_candidates = _candidates[k].size();
+		for (int begin = 0; begin < num_candidates; begin += kTaskSize) {
+			_tasks.push_back(Task{k, begin, std::min(begin + kTaskSize, num_candidates)});
+		}
+	}
+	const int num_tasks = _tasks.size();
+	if (static_cast<int>(_task_contacts.size()) < num_tasks) {
+		_task_contacts.resize(num_tasks);
+	}
+
+	_batch_workspaces.resize(omp_get_max_threads());
+
+	#pragma omp parallel for schedule(dynamic)
+	for (int t = 0; t < num_tasks; t++) {
+		const auto& task = _tasks[t];
+		const auto [i1, i2] = _object_pairs[task._pair];
+		const auto &surface_vertices1 = _surface_vertices[i1];
+		const auto &surface_topo1 = _surface_topos[i1];
+		const auto &surface_vertices2 = _surface_vertices[i2];
+		const auto &surface_topo2 = _surface_topos[i2];
+		auto &contacts = _task_contacts[t];
+		contacts.clear();
+
+		auto& workspace = _batch_workspaces[omp_get_thread_num()];
+		auto& batch = workspace._batch;
+		batch.Resize(task._end - task._begin);
+		for (int c = task._begin; c < task._end; c++) {
+			const auto [face_id1, face_id2] = _candidates[task._pair][c];
+			for (int v = 0; v < 3; v++) {
+				batch.SetFirst(c - task._begin, v, surface_vertices1.row(surface_topo1(face_id1, v)));
+				batch.SetSecond(c - task._begin, v, surface_vertices2.row(surface_topo2(face_id2, v)));
+			}
+		}
+		_dcd->GetIntersected(batch, workspace._hits, workspace._points, workspace._normals);
+
+		// The point is on both triangles, weighted by its closest points
+		const int num_hits = workspace._hits.size();
+		for (int h = 0; h < num_hits; h++) {
+			const int c = workspace._hits[h];
+			const auto [face_id1, face_id2] = _candidates[task._pair][task._begin + c];
+			contacts.push_back(ContactPoint(
+				i1, i2,
+				face_id1, face_id2,
+				workspace._points[h], workspace._normals[h]
+			));
+			PointTriangleDistance(workspace._points[h], batch.GetFirst(c, 0), batch.GetFirst(c, 1), batch.GetFirst(c, 2),
+								  contacts.back()._barycentric1);
+			PointTriangleDistance(workspace._points[h], batch.GetSecond(c, 0), batch.GetSecond(c, 1), batch.GetSecond(c, 2),
+								  contacts.back()._barycentric2);
+		}
+	}
+
+	// Merge in the order of the tasks, so the result does not depend on the
+	// number of threads
+	for (int t = 0; t < num_tasks; t++) {
+		contact_points.insert(contact_points.end(), _task_contacts[t].begin(), _task_contacts[t].end());
+	}
+}
+
+void DCDContactGenerator::GetRoles(const vector<Object*> &objects) const {
+	const int num_objs = objects.size();
+	_roles.assign(num_objs, kTriangles);
+	if (_rigid_contact != RigidContactType::kAnalytic) {
+		return;
+	}
+	for (int i = 0; i < num_objs; i++) {
+		if (objects[i]->IsDeformable()) {
+			_roles[i] = kDeformable;
+		} else if (objects[i]->HasSignedDistance()) {
+			_roles[i] = kDistance;
+		}
+	}
+}
+
+bool DCDContactGenerator::IsAnalytic(int obj1, int obj2) const {
+	return (_roles[obj1] == kDistance && _roles[obj2] == kDeformable)
+		|| (_roles[obj1] == kDeformable && _roles[obj2] == kDistance);
+}
+
+void DCDContactGenerator::AnalyticPhase(const vector<Object*> &objects, vector<ContactPoint> &contact_points) const {
+	for (const auto& [i1, i2] : _analytic_pairs) {
+		const Object& primitive = *objects[i1];
+		const auto& vertices = _surface_vertices[i2];
+		const auto& topo = _surface_topos[i2];
+		const int num_vertices = vertices.rows(), num_faces = topo.rows();
+
+		// Features outside the box of the primitive are not tested
+		const AABB& box = _boxes[i1];
+
+		// A face around each vertex, and the edges, each taken from the face
+		// going along it in ascending order, the surface being closed
+		_vertex_faces.assign(num_vertices, -1);
+		_edges.clear();
+		for (int f = 0; f < num_faces; f++) {
+			for (int k = 0; k < 3; k++) {
+				const int begin = topo(f, k), end = topo(f, (k + 1) % 3);
+				if (_vertex_faces[begin] == -1) {
+					_vertex_faces[begin] = f;
+				}
+				if (begin < end) {
+					_edges.push_back(Edge{begin, end, f});
 				}
 			}
 		}
+		const int num_edges = _edges.size();
+		_distances.resize(num_vertices + num_edges);
+		_gradients.resize(num_vertices + num_edges);
+		_edge_params.resize(num_edges);
+
+		#pragma omp parallel for
+		for (int v = 0; v < num_vertices; v++) {
+			const Vector3d point = vertices.row(v).transpose();
+			AABB point_box;
+			point_box.Extend(point);
+			_distances[v] = box.Overlap(point_box) ? primitive.SignedDistance(point, _gradients[v]) : kInfinity;
+		}
+
+		// Edges passing through with both vertices outside, the deepest point
+		// is found by a golden section search, exact for convex primitives
+		#pragma omp parallel for schedule(dynamic, 64)
+		for (int e = 0; e < num_edges; e++) {
+			const auto& edge = _edges[e];
+			double& distance = _distances[num_vertices + e];
+			distance = kInfinity;
+			if (!(_distances[edge._begin] > 0 && _distances[edge._end] > 0)) {
+				continue;
+			}
+			const Vector3d begin = vertices.row(edge._begin).transpose(), end = vertices.row(edge._end).transpose();
+			AABB edge_box;
+			edge_box.Extend(begin);
+			edge_box.Extend(end);
+			if (!box.Overlap(edge_box)) {
+				continue;
+			}
+			Vector3d gradient;
+			double lower = 0, upper = 1;
+			double t1 = upper - kGoldenRatio, t2 = lower + kGoldenRatio;
+			double d1 = primitive.SignedDistance(begin + t1 * (end - begin), gradient);
+			double d2 = primitive.SignedDistance(begin + t2 * (end - begin), gradient);
+			for (int i = 0; i < kEdgeIterations; i++) {
+				if (d1 < d2) {
+					upper = t2, t2 = t1, d2 = d1;
+					t1 = upper - kGoldenRatio * (upper - lower);
+					d1 = primitive.SignedDistance(begin + t1 * (end - begin), gradient);
+				} else {
+					lower = t1, t1 = t2, d1 = d2;
+					t2 = lower + kGoldenRatio * (upper - lower);
+					d2 = primitive.SignedDistance(begin + t2 * (end - begin), gradient);
+				}
+			}
+			_edge_params[e] = (lower + upper) / 2;
+			distance = primitive.SignedDistance(begin + _edge_params[e] * (end - begin), _gradients[num_vertices + e]);
+		}
+
+		for (int v = 0; v < num_vertices; v++) {
+			if (_distances[v] < 0 && _vertex_faces[v] != -1) {
+				const int face = _vertex_faces[v];
+				const double weight = 1;
+				contact_points.emplace_back(i1, i2, -1, face, vertices.row(v).transpose(), _gradients[v]);
+				contact_points.back()._depth = -_distances[v];
+				contact_points.back()._barycentric2 = FaceWeights(topo.row(face), &v, &weight, 1);
+			}
+		}
+		for (int e = 0; e < num_edges; e++) {
+			if (_distances[num_vertices + e] < 0) {
+				const auto& edge = _edges[e];
+				const double t = _edge_params[e];
+				const Vector3d point = (1 - t) * vertices.row(edge._begin) + t * vertices.row(edge._end);
+				const int edge_vertices[2] = {edge._begin, edge._end};
+				const double weights[2] = {1 - t, t};
+				contact_points.emplace_back(i1, i2, -1, edge._face, point, _gradients[num_vertices + e]);
+				contact_points.back()._depth = -_distances[num_vertices + e];
+				contact_points.back()._barycentric2 = FaceWeights(topo.row(edge._face), edge_vertices, weights, 2);
+			}
+		}
 	}
-}
\ No newline at end of file
+}
@@ -7,16 +7,31 @@
 
 #include "ContactGenerator.h"
 #include "DCD/DCD.h"
+#include "BroadPhase/SweepAndPrune.h"
 
 class DCDContactGeneratorParameter : public ContactGeneratorParameter {
 public:
-	DCDContactGeneratorParameter(const DCDType& type, const DCDParameter& para) : ContactGeneratorParameter() {
+	/**
+	 * @param self_collision whether deformable objects are tested against
+	 * 		  themselves, only the BVH broad phase supports it
+	 * @param manifold_size, rigid_contact see ContactGeneratorParameter
+	 * @param cache_steps steps of motion at the current speed the candidate
+	 * 		  pairs are found for, 0 finds them every step, only the BVH
+	 * 		  broad phase supports it
+	 */
+	DCDContactGeneratorParameter(const DCDType& type, const DCDParameter& para, bool self_collision = false, int manifold_size = 0,
+								 RigidContactType rigid_contact = RigidContactType::kTriangle, int cache_steps = 0)
+	: ContactGeneratorParameter(manifold_size, rigid_contact) {
 		_dcd_type = type;
 		_dcd_parameter = para.Clone();
+		_self_collision = self_collision;
+		_cache_steps = cache_steps;
 	}
 	DERIVED_DECLARE_CLONE(ContactGeneratorParameter)
 	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(DCDType, DCDType, _dcd_type)
 	DECLARE_OVERWRITE_ACCESSIBLE_POINTER_MEMBER(DCDParameter, DCDPara, _dcd_parameter)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(bool, SelfCollision, _self_collision)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(int, CacheSteps, _cache_steps)
 };
 
 class DCDContactGenerator : public ContactGenerator {
@@ -24,11 +39,110 @@ public:
 	void Initialize(const ContactGeneratorParameter &para) override;
 	void GetContact(const System &system, vector<ContactPoint> &contact_points) const override;
 
+	bool UsesBVH() const override {
+		return true;
+	}
+
 	virtual ~DCDContactGenerator() {
 		delete _dcd;
 	}
 protected:
+	/**
+	 * Find the object pairs and the candidate triangle pairs of each, with
+	 * the boxes grown by _margin, into _object_pairs, _analytic_pairs and
+	 * _candidates. The candidates of the self collision pairs are left out,
+	 * as the normal cones culling them do not carry over to later steps.
+	 */
+	void BroadPhase(const vector<Object*> &objects) const;
+
+	/**
+	 * Check the surfaces against those the candidates were found for. A pair
+	 * of triangles intersecting now was within the sum of the displacements
+	 * of their objects then, so the candidates hold while no surface has
+	 * moved farther than _margin. Otherwise the surfaces are recorded and
+	 * the margin is set from the displacement of the last step.
+	 * @return whether the candidates of the last BroadPhase still hold
+	 */
+	bool IsCacheValid() const;
+
+	/**
+	 * Test the candidate triangle pairs in _candidates, in parallel, each
+	 * task gathering its candidates into a batch for the DCD
+	 * @param contact_points OUTPUT, the contacts are appended to it, in the
+	 * 		  order of _object_pairs and then the order of the candidates
+	 */
+	void NarrowPhase(vector<ContactPoint> &contact_points) const;
+
+	//-> fill in _roles for the objects
+	void GetRoles(const vector<Object*> &objects) const;
+
+	//-> whether the pair of objects is tested by AnalyticPhase instead of by triangles
+	bool IsAnalytic(int obj1, int obj2) const;
+
+	/**
+	 * Test the surface vertices and edges of the deformable object of each
+	 * pair in _analytic_pairs against the signed distance of the other one,
+	 * vertices inside and points of edges passing through become contacts
+	 * @param contact_points OUTPUT, the contacts are appended to it, in the
+	 * 		  order of _analytic_pairs, vertices before edges
+	 */
+	void AnalyticPhase(const vector<Object*> &objects, vector<ContactPoint> &contact_points) const;
+
 	DCD* _dcd;
+	bool _self_collision;
+	RigidContactType _rigid_contact;
+	int _cache_steps;
+
+	enum Role {
+		kTriangles,		// tested by triangles against everything
+		kDistance,		// tested by its signed distance against the deformable objects
+		kDeformable		// tested by its vertices and edges against the signed distances
+	};
+	mutable vector<Role> _roles;		// one per object
+
+	// Workspace, one entry per object
+	mutable vector<RowMatrixX3dRef> _surface_vertices;		// views of the surfaces of the objects
+	mutable vector<Eigen::Ref<const Matrix<int, Dynamic, 3>>> _surface_topos;
+	mutable vector<Matrix3d> _rotations;		// frames of the BVHs
+	mutable vector<Vector3d> _translations;
+	mutable vector<AABB> _boxes;				// world space boxes
+
+	// Workspace of the broad and narrow phase
+	mutable vector<std::pair<int, int>> _object_pairs;	// object pairs passing the broad phase
+	mutable vector<vector<std::pair<int, int>>> _candidates;	// candidate triangle pairs of each object pair
+
+	// Candidates kept between the steps
+	mutable double _margin = 0;						// growth of the boxes in the last BroadPhase
+	mutable vector<RowMatrixX3d> _cached_surfaces;	// surfaces of the last BroadPhase
+	mutable vector<RowMatrixX3d> _last_surfaces;	// surfaces of the last call
+	mutable vector<AABB> _inflated_boxes;
+
+	struct Task {
+		int _pair;			// index into _object_pairs
+		int _begin, _end;	// range of the candidates of the pair
+	};
+	mutable vector<Task> _tasks;
+	mutable vector<vector<ContactPoint>> _task_contacts;		// one buffer per task
+
+	struct BatchWorkspace {
+		TrianglePairBatch _batch;	// the candidates of a task
+		vector<int> _hits;
+		vector<Vector3d> _points, _normals;
+	};
+	mutable vector<BatchWorkspace> _batch_workspaces;		// one per thread
+	mutable SweepAndPrune _sweep_and_prune;
+
+	// Workspace of the analytic phase
+	mutable vector<std::pair<int, int>> _analytic_pairs;	// (object with the distance, deformable object)
+	struct Edge {
+		int _begin, _end;	// vertices
+		int _face;			// a face containing the edge
+	};
+	mutable vector<int> _vertex_faces;			// a face containing each vertex
+	mutable vector<Edge> _edges;
+	mutable vector<double> _distances;			// of the vertices, then of the nearest points of the edges
+	mutable vector<double> _edge_params;		// position of the nearest point along each edge
+	mutable vector<Vector3d> _gradients;		// the same layout as _distances
 };
 
 #endif //FEM_DCDCONTACTGENERATOR_H
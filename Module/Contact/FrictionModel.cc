@@ -5,4 +5,13 @@
 #include "FrictionModel.h"
 #include "Util/Pattern.h"
 
-DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(FrictionModelParameter, int, NumTangent)
\ No newline at end of file
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(FrictionModelParameter, int, NumTangent)
+DEFINE_ACCESSIBLE_MEMBER(FrictionModelParameter, double, Stiffness, _stiffness)
+
+void FrictionModel::Initialize(const FrictionModelParameter &para) {
+	_stiffness = para.GetStiffness();
+}
+
+double FrictionModel::GetCompliance(double h) const {
+	return _stiffness > 0 ? 1 / (h * h * _stiffness) : 0;
+}
\ No newline at end of file
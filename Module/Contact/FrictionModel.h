@@ -9,21 +9,27 @@
 #include <stdexcept>
 
 enum class FrictionModelType {
-	kInscribedPolygon
+	kInscribedPolygon,
+	kCone
 };
 
 class FrictionModelParameter {
 public:
-	FrictionModelParameter() = default;
+	/**
+	 * @param stiffness stiffness of the contacts, regularizing the problem,
+	 * 		  0 for rigid contacts, which is the default
+	 */
+	explicit FrictionModelParameter(double stiffness = 0) : _stiffness(stiffness) {}
 	FrictionModelParameter(const FrictionModelParameter& rhs) = default;
 	virtual ~FrictionModelParameter() = default;
 	BASE_DECLARE_CLONE(FrictionModelParameter)
 	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(int, NumTangent)
+	DECLARE_ACCESSIBLE_MEMBER(double, Stiffness, _stiffness)
 };
 
 class FrictionModel {
 public:
-	virtual void Initialize(const FrictionModelParameter &para) {};
+	virtual void Initialize(const FrictionModelParameter &para);
 
 	/**
 	 * @param system INPUT, the physical systems
@@ -41,6 +47,16 @@ public:
 	virtual int GetNumTangent() const {
 		throw std::logic_error("Unimplemented method");
 	}
+
+	/**
+	 * Compliance of the contacts, to be added to the diagonal of the LCP
+	 * @param h the time step
+	 * @return 1 / (h^2 k) where k is the contact stiffness, 0 for rigid contacts
+	 */
+	double GetCompliance(double h) const;
+
+protected:
+	double _stiffness = 0;
 };
 
 #endif //FEM_FRICTION_H
@@ -5,11 +5,13 @@
 #include "PolygonFrictionModel.h"
 #include <Eigen/CholmodSupport>
 #include <spdlog/spdlog.h>
+#include <omp.h>
 
 DEFINE_ACCESSIBLE_MEMBER(PolygonFrictionModelParameter, int, NumTangent, _num_tangent)
 DEFINE_CLONE(FrictionModelParameter, PolygonFrictionModelParameter)
 
 void PolygonFrictionModel::Initialize(const FrictionModelParameter &para) {
+	FrictionModel::Initialize(para);
 	_num_tangent = para.GetNumTangent();
 	_sin.resize(_num_tangent);
 	_cos.resize(_num_tangent);
@@ -31,57 +33,58 @@ void PolygonFrictionModel::GetJ(const System &system,
 	JnT.resize(num_contact, dof), JtT.resize(num_contact * _num_tangent, dof);
 	Mu.resize(contacts.size());
 
-	COO coo_n, coo_t;
-	int cur_num_contact = 0;
-	for (auto& contact : contacts) {
-		const auto& obj1 = objects[contact._obj1], obj2 = objects[contact._obj2];
-		const Vector3d point = contact._point, normal = contact._normal;
-		const SparseMatrixXd point_sparse = point.sparseView(), normal_sparse = normal.sparseView();
-		const int offset1 = system.GetOffset(contact._obj1), offset2 = system.GetOffset(contact._obj2);
-		SparseMatrixXd J1 = obj1->GetJ(contact._idx1, point);
-		SparseMatrixXd J2 = obj2->GetJ(contact._idx2, point);
-		SparseMatrixXd Jn1 = -normal_sparse.transpose() * J1;
-		SparseMatrixXd Jn2 = normal_sparse.transpose() * J2;
-		for (int k = 0; k < Jn1.outerSize(); k++) {
-			for (SparseMatrixXd::InnerIterator it(Jn1, k); it; ++it) {
-				coo_n.push_back(Tripletd(it.row() + cur_num_contact, it.col() + offset1, it.value()));
-			}
-		}
-		for (int k = 0; k < Jn2.outerSize(); k++) {
-			for (SparseMatrixXd::InnerIterator it(Jn2, k); it; ++it) {
-				coo_n.push_back(Tripletd(it.row() + cur_num_contact, it.col() + offset2, it.value()));
-			}
-		}
+	// The rows of a contact follow from its index, so the contacts are
+	// spread over the threads, each appending to its own entries. The
+	// region may run with fewer threads, all the buffers are cleared first
+	const int num_threads = omp_get_max_threads();
+	_thread_coo_n.resize(num_threads);
+	_thread_coo_t.resize(num_threads);
+	for (int t = 0; t < num_threads; t++) {
+		_thread_coo_n[t].clear();
+		_thread_coo_t[t].clear();
+	}
+	#pragma omp parallel
+	{
+		auto& coo_n = _thread_coo_n[omp_get_thread_num()];
+		auto& coo_t = _thread_coo_t[omp_get_thread_num()];
 
-		Vector3d tangent1, tangent2;
-		tangent1.x() = tangent1.y() = normal.z();
-		tangent1.z() = - normal.x() - normal.y();
-		assert(tangent1.dot(normal) < 1e-5);
-		assert(tangent1.dot(normal) > -1e-5);
-		tangent1 = (Vector3d)tangent1.normalized();
-		tangent2 = tangent1.cross(normal);
+		#pragma omp for schedule(static)
+		for (int c = 0; c < num_contact; c++) {
+			const auto& contact = contacts[c];
+			const auto& obj1 = objects[contact._obj1], obj2 = objects[contact._obj2];
+			const Vector3d point = contact._point, normal = contact._normal;
+			const double weight = contact._weight;
+			const int offset1 = system.GetOffset(contact._obj1), offset2 = system.GetOffset(contact._obj2);
+			obj1->AppendJ(contact._idx1, contact._barycentric1, point, normal, -weight, c, offset1, coo_n);
+			obj2->AppendJ(contact._idx2, contact._barycentric2, point, normal, weight, c, offset2, coo_n);
 
-		for (int i = 0; i < _num_tangent; i++) {
-			const Vector3d tangent = _cos[i] * tangent1 + _sin[i] * tangent2;
-			const SparseMatrixXd tangent_sparse = tangent.sparseView();
-			SparseMatrixXd Jt1 = -tangent_sparse.transpose() * J1;
-			SparseMatrixXd Jt2 =  tangent_sparse.transpose() * J2;
-			for (int k = 0; k < Jt1.outerSize(); k++) {
-				for (SparseMatrixXd::InnerIterator it(Jt1, k); it; ++it) {
-					coo_t.push_back(Tripletd(it.row() + cur_num_contact * _num_tangent + i, it.col() + offset1, it.value()));
-				}
-			}
-			for (int k = 0; k < Jt2.outerSize(); k++) {
-				for (SparseMatrixXd::InnerIterator it(Jt2, k); it; ++it) {
-					coo_t.push_back(Tripletd(it.row() + cur_num_contact * _num_tangent + i, it.col() + offset2, it.value()));
-				}
+			Vector3d tangent1, tangent2;
+			tangent1.x() = tangent1.y() = normal.z();
+			tangent1.z() = - normal.x() - normal.y();
+			assert(tangent1.dot(normal) < 1e-5);
+			assert(tangent1.dot(normal) > -1e-5);
+			tangent1 = (Vector3d)tangent1.normalized();
+			tangent2 = tangent1.cross(normal);
+
+			for (int i = 0; i < _num_tangent; i++) {
+				const Vector3d tangent = _cos[i] * tangent1 + _sin[i] * tangent2;
+				obj1->AppendJ(contact._idx1, contact._barycentric1, point, tangent, -weight, c * _num_tangent + i, offset1, coo_t);
+				obj2->AppendJ(contact._idx2, contact._barycentric2, point, tangent, weight, c * _num_tangent + i, offset2, coo_t);
 			}
+			Mu(c) = std::max(obj1->GetMu(), obj2->GetMu());
 		}
-		Mu(cur_num_contact) = std::max(obj1->GetMu(), obj2->GetMu());
-		cur_num_contact++;
 	}
-	JnT.setFromTriplets(coo_n.begin(), coo_n.end());
-	JtT.setFromTriplets(coo_t.begin(), coo_t.end());
+
+	// The static schedule hands the threads consecutive ranges of contacts
+	// in order, so the entries come in the order of the contacts
+	_coo_n.clear();
+	_coo_t.clear();
+	for (int t = 0; t < num_threads; t++) {
+		_coo_n.insert(_coo_n.end(), _thread_coo_n[t].begin(), _thread_coo_n[t].end());
+		_coo_t.insert(_coo_t.end(), _thread_coo_t[t].begin(), _thread_coo_t[t].end());
+	}
+	JnT.setFromTriplets(_coo_n.begin(), _coo_n.end());
+	JtT.setFromTriplets(_coo_t.begin(), _coo_t.end());
 }
 
 int PolygonFrictionModel::GetNumTangent() const {
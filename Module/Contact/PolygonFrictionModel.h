@@ -9,7 +9,12 @@
 
 class PolygonFrictionModelParameter : public FrictionModelParameter {
 public:
-	PolygonFrictionModelParameter(int num_tangent) : _num_tangent(num_tangent) {}
+	/**
+	 * @param stiffness stiffness of the contacts, regularizing the LCP,
+	 * 		  0 for rigid contacts
+	 */
+	PolygonFrictionModelParameter(int num_tangent, double stiffness = 0)
+	: FrictionModelParameter(stiffness), _num_tangent(num_tangent) {}
 	DERIVED_DECLARE_CLONE(FrictionModelParameter)
 	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(int, NumTangent, _num_tangent)
 };
@@ -26,6 +31,10 @@ public:
 protected:
 	int _num_tangent;
 	vector<double> _sin, _cos;
+
+	// Workspace of GetJ
+	mutable vector<COO> _thread_coo_n, _thread_coo_t;	// one per thread
+	mutable COO _coo_n, _coo_t;
 };
 
 #endif //FEM_POLYGONFRICTIONMODEL_H
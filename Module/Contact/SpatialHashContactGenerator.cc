@@ -0,0 +1,269 @@
+#include "SpatialHashContactGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
+
+DEFINE_CLONE(ContactGeneratorParameter, SpatialHashContactGeneratorParameter)
+DEFINE_ACCESSIBLE_MEMBER(SpatialHashContactGeneratorParameter, double, CellScale, _cell_scale)
+
+namespace {
+	const int kMaxCellsPerAxis = 8;	// larger triangles are kept out of the grid
+
+	unsigned Hash(const std::array<int, 3> &cell) {
+		return static_cast<unsigned>(cell[0]) * 73856093u
+			 ^ static_cast<unsigned>(cell[1]) * 19349663u
+			 ^ static_cast<unsigned>(cell[2]) * 83492791u;
+	}
+}
+
+void SpatialHashContactGenerator::Initialize(const ContactGeneratorParameter &para) {
+	DCDContactGenerator::Initialize(para);
+	_cell_scale = para.GetCellScale();
+}
+
+void SpatialHashContactGenerator::GetCellRange(int triangle, Cell &lower, Cell &upper) const {
+	const auto& box = _triangle_boxes[triangle];
+	for (int i = 0; i < 3; i++) {
+		lower[i] = static_cast<int>(std::floor(box._min(i) / _cell_size));
+		upper[i] = static_cast<int>(std::floor(box._max(i) / _cell_size));
+	}
+}
+
+void SpatialHashContactGenerator::SortEntries(int num_buckets) const {
+	const int num_entries = _entries.size();
+	const int num_chunks = omp_get_max_threads();
+	const int chunk_size = (num_entries + num_chunks - 1) / num_chunks;
+	_histograms.resize(num_chunks);
+
+	#pragma omp parallel for schedule(static)
+	for (int c = 0; c < num_chunks; c++) {
+		auto& histogram = _histograms[c];
+		histogram.assign(num_buckets, 0);
+		const int end = std::min(num_entries, (c + 1) * chunk_size);
+		for (int e = c * chunk_size; e < end; e++) {
+			histogram[_entries[e]._bucket]++;
+		}
+	}
+
+	// Bucket major and chunk minor, so the sort is stable
+	_bucket_offsets.resize(num_buckets + 1);
+	int offset = 0;
+	for (int b = 0; b < num_buckets; b++) {
+		_bucket_offsets[b] = offset;
+		for (int c = 0; c < num_chunks; c++) {
+			const int count = _histograms[c][b];
+			_histograms[c][b] = offset;
+			offset += count;
+		}
+	}
+	_bucket_offsets[num_buckets] = offset;
+
+	_sorted.resize(num_entries);
+	#pragma omp parallel for schedule(static)
+	for (int c = 0; c < num_chunks; c++) {
+		auto& histogram = _histograms[c];
+		const int end = std::min(num_entries, (c + 1) * chunk_size);
+		for (int e = c * chunk_size; e < end; e++) {
+			_sorted[histogram[_entries[e]._bucket]++] = _entries[e];
+		}
+	}
+}
+
+void SpatialHashContactGenerator::TestPair(int triangle1, int triangle2, vector<std::array<int, 4>> &candidates) const {
+	int object1 = _triangle_object[triangle1], object2 = _triangle_object[triangle2];
+	if (object1 == object2 || !(_groups[object1] & _masks[object2]) || !(_groups[object2] & _masks[object1])
+		|| IsAnalytic(object1, object2) || !_triangle_boxes[triangle1].Overlap(_triangle_boxes[triangle2])) {
+		return;
+	}
+	if (object1 < object2) {
+		std::swap(object1, object2);
+		std::swap(triangle1, triangle2);
+	}
+	candidates.push_back({object1, object2, triangle1 - _face_offsets[object1], triangle2 - _face_offsets[object2]});
+}
+
+void SpatialHashContactGenerator::GetContact(const System &system,
+											 vector<ContactPoint> &contact_points) const {
+	contact_points.clear();
+	const auto &objects = system.GetObjects();
+	const int num_objs = objects.size();
+
+	_surface_vertices.clear();
+	_surface_topos.clear();
+	_face_offsets.resize(num_objs + 1);
+	_face_offsets[0] = 0;
+	_groups.resize(num_objs);
+	_masks.resize(num_objs);
+	for (int i = 0; i < num_objs; i++) {
+		_groups[i] = objects[i]->GetCollisionGroup();
+		_masks[i] = objects[i]->GetCollisionMask();
+		_surface_vertices.push_back(objects[i]->GetSurfacePosition());
+		_surface_topos.push_back(objects[i]->GetSurfaceTopo());
+		_face_offsets[i + 1] = _face_offsets[i] + _surface_topos[i].rows();
+	}
+	const int num_triangles = _face_offsets[num_objs];
+	if (num_triangles == 0) {
+		return;
+	}
+
+	// Pairs of a deformable object and one with a signed distance skip the
+	// triangles, and are paired up by the boxes of their trees
+	GetRoles(objects);
+	_analytic_pairs.clear();
+	_boxes.assign(num_objs, AABB());
+	for (int i = 0; i < num_objs; i++) {
+		const auto& vertices = _surface_vertices[i];
+		for (int j = 0; j < vertices.rows(); j++) {
+			_boxes[i].Extend(vertices.row(j).transpose());
+		}
+	}
+	for (int i = 0; i < num_objs; i++) {
+		for (int j = 0; j < num_objs; j++) {
+			if (_roles[i] == kDistance && _roles[j] == kDeformable
+				&& objects[i]->CanCollide(*objects[j]) && _boxes[i].Overlap(_boxes[j])) {
+				_analytic_pairs.emplace_back(i, j);
+			}
+		}
+	}
+
+	// Boxes of the triangles, and the cell size from the average edge length
+	_triangle_object.resize(num_triangles);
+	_triangle_boxes.resize(num_triangles);
+	double edge_length = 0;
+	for (int i = 0; i < num_objs; i++) {
+		const auto& vertices = _surface_vertices[i];
+		const auto& topo = _surface_topos[i];
+		const int num_faces = topo.rows();
+		#pragma omp parallel for reduction(+:edge_length)
+		for (int j = 0; j < num_faces; j++) {
+			AABB box;
+			for (int k = 0; k < 3; k++) {
+				box.Extend(vertices.row(topo(j, k)).transpose());
+				edge_length += (vertices.row(topo(j, k)) - vertices.row(topo(j, (k + 1) % 3))).norm();
+			}
+			_triangle_boxes[_face_offsets[i] + j] = box;
+			_triangle_object[_face_offsets[i] + j] = i;
+		}
+	}
+	_cell_size = _cell_scale * edge_length / (3 * num_triangles);
+	if (!(_cell_size > 0)) {
+		return;
+	}
+
+	// Count the cells of each triangle and fill in the entries
+	_entry_offsets.resize(num_triangles + 1);
+	_entry_offsets[0] = 0;
+	#pragma omp parallel for
+	for (int t = 0; t < num_triangles; t++) {
+		Cell lower, upper;
+		GetCellRange(t, lower, upper);
+		int num_cells = 1;
+		for (int i = 0; i < 3; i++) {
+			const int span = upper[i] - lower[i] + 1;
+			num_cells = span > kMaxCellsPerAxis ? 0 : num_cells * span;
+		}
+		_entry_offsets[t + 1] = num_cells;
+	}
+	_large.clear();
+	for (int t = 0; t < num_triangles; t++) {
+		if (_entry_offsets[t + 1] == 0) {
+			_large.push_back(t);
+		}
+		_entry_offsets[t + 1] += _entry_offsets[t];
+	}
+
+	const int num_entries = _entry_offsets[num_triangles];
+	int num_buckets = 1;
+	while (num_buckets < num_entries) {
+		num_buckets <<= 1;
+	}
+	_entries.resize(num_entries);
+	#pragma omp parallel for
+	for (int t = 0; t < num_triangles; t++) {
+		Cell lower, upper;
+		GetCellRange(t, lower, upper);
+		int e = _entry_offsets[t];
+		if (e == _entry_offsets[t + 1]) {
+			continue;
+		}
+		Cell cell;
+		for (cell[0] = lower[0]; cell[0] <= upper[0]; cell[0]++) {
+			for (cell[1] = lower[1]; cell[1] <= upper[1]; cell[1]++) {
+				for (cell[2] = lower[2]; cell[2] <= upper[2]; cell[2]++) {
+					_entries[e++] = Entry{Hash(cell) & (num_buckets - 1), cell, t};
+				}
+			}
+		}
+	}
+	SortEntries(num_buckets);
+
+	// Pairs sharing a cell, each reported only in the lowest cell they share
+	const int num_threads = omp_get_max_threads();
+	_thread_candidates.resize(num_threads);
+	for (auto& candidates : _thread_candidates) {
+		candidates.clear();
+	}
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int b = 0; b < num_buckets; b++) {
+		auto& candidates = _thread_candidates[omp_get_thread_num()];
+		for (int e1 = _bucket_offsets[b]; e1 < _bucket_offsets[b + 1]; e1++) {
+			const auto& entry1 = _sorted[e1];
+			Cell lower1, upper1;
+			GetCellRange(entry1._triangle, lower1, upper1);
+			for (int e2 = e1 + 1; e2 < _bucket_offsets[b + 1]; e2++) {
+				const auto& entry2 = _sorted[e2];
+				if (entry1._cell != entry2._cell) {
+					continue;
+				}
+				Cell lower2, upper2;
+				GetCellRange(entry2._triangle, lower2, upper2);
+				bool lowest = true;
+				for (int i = 0; i < 3; i++) {
+					lowest = lowest && entry1._cell[i] == std::max(lower1[i], lower2[i]);
+				}
+				if (lowest) {
+					TestPair(entry1._triangle, entry2._triangle, candidates);
+				}
+			}
+		}
+	}
+
+	// Large triangles against everything, pairs of them once
+	const int num_large = _large.size();
+	#pragma omp parallel for schedule(dynamic)
+	for (int l = 0; l < num_large; l++) {
+		auto& candidates = _thread_candidates[omp_get_thread_num()];
+		const int t = _large[l];
+		for (int u = 0; u < num_triangles; u++) {
+			if (_entry_offsets[u] == _entry_offsets[u + 1] && u >= t) {
+				continue;
+			}
+			TestPair(t, u, candidates);
+		}
+	}
+
+	// Sort the candidates so the result does not depend on the threads
+	vector<std::array<int, 4>> all_candidates;
+	for (const auto& candidates : _thread_candidates) {
+		all_candidates.insert(all_candidates.end(), candidates.begin(), candidates.end());
+	}
+	std::sort(all_candidates.begin(), all_candidates.end());
+
+	_object_pairs.clear();
+	int num_pairs = 0;
+	for (const auto& candidate : all_candidates) {
+		const std::pair<int, int> object_pair(candidate[0], candidate[1]);
+		if (num_pairs == 0 || _object_pairs.back() != object_pair) {
+			_object_pairs.push_back(object_pair);
+			if (static_cast<int>(_candidates.size()) <= num_pairs) {
+				_candidates.resize(num_pairs + 1);
+			}
+			_candidates[num_pairs++].clear();
+		}
+		_candidates[num_pairs - 1].emplace_back(candidate[2], candidate[3]);
+	}
+
+	NarrowPhase(contact_points);
+	AnalyticPhase(objects, contact_points);
+	_reduction.Reduce(contact_points);
+}
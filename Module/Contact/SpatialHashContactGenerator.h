@@ -0,0 +1,75 @@
+#ifndef FEM_SPATIALHASHCONTACTGENERATOR_H
+#define FEM_SPATIALHASHCONTACTGENERATOR_H
+
+#include "DCDContactGenerator.h"
+#include <array>
+
+class SpatialHashContactGeneratorParameter : public DCDContactGeneratorParameter {
+public:
+	/**
+	 * @param cell_scale edge length of the grid cells, relative to the
+	 * 		  average edge length of the surface triangles
+	 * @param manifold_size, rigid_contact see ContactGeneratorParameter
+	 */
+	SpatialHashContactGeneratorParameter(const DCDType& type, const DCDParameter& para, double cell_scale = 1, int manifold_size = 0,
+										 RigidContactType rigid_contact = RigidContactType::kTriangle)
+	: DCDContactGeneratorParameter(type, para, false, manifold_size, rigid_contact), _cell_scale(cell_scale) {}
+	DERIVED_DECLARE_CLONE(ContactGeneratorParameter)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(double, CellScale, _cell_scale)
+};
+
+/**
+ * Broad phase hashing the boxes of the surface triangles of all the objects
+ * into a uniform grid, rebuilt every step. It suits scenes of many small
+ * objects, where the trees per object cost more than they save.
+ * Triangles much larger than a cell, like those of the slabs, are kept out
+ * of the grid and tested against every triangle box instead.
+ */
+class SpatialHashContactGenerator : public DCDContactGenerator {
+public:
+	void Initialize(const ContactGeneratorParameter &para) override;
+	void GetContact(const System &system, vector<ContactPoint> &contact_points) const override;
+
+	// the boxes of the objects are taken from their surfaces
+	bool UsesBVH() const override {
+		return false;
+	}
+
+protected:
+	typedef std::array<int, 3> Cell;
+
+	struct Entry {
+		unsigned _bucket;
+		Cell _cell;
+		int _triangle;		// global index of the triangle
+	};
+
+	//-> range of the cells overlapped by the box of the triangle
+	void GetCellRange(int triangle, Cell &lower, Cell &upper) const;
+
+	//-> stable parallel counting sort of _entries by bucket into _sorted
+	void SortEntries(int num_buckets) const;
+
+	//-> record the pair of triangles as a candidate if they may collide
+	void TestPair(int triangle1, int triangle2, vector<std::array<int, 4>> &candidates) const;
+
+	double _cell_scale;
+
+	// Workspace, indexed by the objects
+	mutable vector<int> _face_offsets;		// global index of the first triangle of each object
+	mutable vector<unsigned> _groups, _masks;
+
+	// Workspace, indexed by the global index of the triangles
+	mutable vector<int> _triangle_object;
+	mutable vector<AABB> _triangle_boxes;
+	mutable vector<int> _entry_offsets;		// entries of triangle i are [_entry_offsets[i], _entry_offsets[i + 1])
+
+	mutable double _cell_size;
+	mutable vector<int> _large;				// triangles kept out of the grid
+	mutable vector<Entry> _entries, _sorted;
+	mutable vector<int> _bucket_offsets;
+	mutable vector<vector<int>> _histograms;	// one per thread
+	mutable vector<vector<std::array<int, 4>>> _thread_candidates;	// (object1, object2, face1, face2)
+};
+
+#endif //FEM_SPATIALHASHCONTACTGENERATOR_H
@@ -0,0 +1,114 @@
+#include "ConeIntegrator.h"
+#include <Eigen/CholmodSupport>
+#include <spdlog/spdlog.h>
+#include "Util/Timing.h"
+#include "Util/Telemetry.h"
+
+void ConeIntegrator::Initialize(const IntegratorParameter &para) {
+	LCPIntegrator::Initialize(para);
+	_cone_solver.Initialize(*para.GetLCPSolverParameter());
+}
+
+bool ConeIntegrator::Step(System &system,
+						  const ContactGenerator &contact_generator,
+						  const FrictionModel &friction_model, double h) {
+	if (friction_model.GetNumTangent() != 2) {
+		spdlog::error("Cone integrator requires two tangent directions per contact");
+		return false;
+	}
+
+	SparseMatrixXd JnT, JtT;
+	VectorXd Mu;
+
+	vector<ContactPoint> contacts;
+	START_TIMING(gen_contact_t)
+	contact_generator.GetContact(system, contacts);
+	STOP_TIMING_TICK(gen_contact_t, "contact generation");
+	START_TIMING(gen_LCP_t)
+	friction_model.GetJ(system, contacts, JnT, JtT, Mu);
+	STOP_TIMING_TICK(gen_LCP_t, "LCP generation");
+
+	const int num_contact = JnT.rows();
+	spdlog::info("Number of contact points: {}", num_contact);
+
+	int dof = system.GetSysDOF();
+	SparseMatrixXd W(dof, dof);
+
+	VectorXd u, f;
+	SparseMatrixXd mass = system.GetSysMass();
+	system.GetSysV(u);
+	system.GetSysF(f);
+	system.GetSysEnergyHessian(W);
+
+	W *= h * h;
+	W += mass;
+	VectorXd c = mass * u + h * f;
+
+	START_TIMING(precompute_t)
+	Eigen::CholmodSupernodalLLT<SparseMatrixXd> LLT_solver;
+	LLT_solver.compute(W);
+	double alpha = 0.01;
+	int num_retry = 0;
+	while (LLT_solver.info() != Eigen::Success) {
+		spdlog::info("Making W SPD");
+		W += alpha * mass;
+		TELEMETRY(Regularization("CHOLMOD", ++num_retry, alpha));
+		alpha *= 2;
+		LLT_solver.compute(W);
+	}
+	STOP_TIMING_TICK(precompute_t, "precomputing linear equations")
+
+	VectorXd u_plus = LLT_solver.solve(c);
+	if (num_contact != 0) {
+		// Rows ordered as (n, t1, t2) per contact
+		SparseMatrixXd JT(3 * num_contact, dof);
+		COO coo;
+		for (int k = 0; k < JnT.outerSize(); k++) {
+			for (SparseMatrixXd::InnerIterator it(JnT, k); it; ++it) {
+				coo.push_back(Tripletd(3 * it.row(), it.col(), it.value()));
+			}
+		}
+		for (int k = 0; k < JtT.outerSize(); k++) {
+			for (SparseMatrixXd::InnerIterator it(JtT, k); it; ++it) {
+				coo.push_back(Tripletd(3 * (it.row() / 2) + 1 + it.row() % 2, it.col(), it.value()));
+			}
+		}
+		JT.setFromTriplets(coo.begin(), coo.end());
+
+		START_TIMING(solve_t)
+		MatrixXd WiJ = LLT_solver.solve(JT.transpose().toDense());
+		STOP_TIMING_TICK(solve_t, "solving linear equations")
+
+		MatrixXd A = JT * WiJ;
+		VectorXd b = JT * u_plus;
+		AddGap(contacts, h, b, 3);
+		Regularize("contact", A, friction_model.GetCompliance(h));
+
+		if (_x.size() != 3 * num_contact) {
+			_x.setZero(3 * num_contact);
+		}
+		Record(A, b, Mu, _x, num_contact, 2, LCPFrictionType::kCone);
+
+		START_TIMING(t_iter)
+		if (Mu.isZero()) {
+			// Frictionless, only the normal LCP remains
+			VectorXd xn = Eigen::Map<VectorXd, 0, Eigen::InnerStride<3>>(_x.data(), num_contact);
+			MatrixXd Ann = A(Eigen::seqN(0, num_contact, 3), Eigen::seqN(0, num_contact, 3));
+			VectorXd bn = b(Eigen::seqN(0, num_contact, 3));
+			_solver->Solve(DenseLCPOperator(Ann), bn, xn);
+			_x.setZero();
+			_x(Eigen::seqN(0, num_contact, 3)) = xn;
+		} else {
+			_cone_solver.Solve(DenseLCPOperator(A), b, Mu, _x);
+		}
+		STOP_TIMING_TICK(t_iter, "Cone complementarity")
+
+		u_plus += WiJ * _x;
+	}
+	_frame_id++;
+
+	START_TIMING(update_t)
+	system.UpdateDynamic(u_plus, h);
+	STOP_TIMING_TICK(update_t, "updating system")
+	return true;
+}
@@ -0,0 +1,24 @@
+#ifndef FEM_CONEINTEGRATOR_H
+#define FEM_CONEINTEGRATOR_H
+
+#include "LCPIntegrator.h"
+#include "NumericSolver/LCPSolver/ConePGS.h"
+
+/**
+ * Integrator with the exact friction cone, to be used with ConeFrictionModel.
+ * Normal and friction forces are solved together by the blocked cone PGS,
+ * the LCP solver only handles frictionless steps, where the problem
+ * reduces to the normal LCP.
+ */
+class ConeIntegrator : public LCPIntegrator {
+public:
+	void Initialize(const IntegratorParameter &para) override;
+	bool Step(System &system, const ContactGenerator &contact_generator,
+			  const FrictionModel &friction_model, double h) override;
+
+protected:
+	ConePGS _cone_solver;
+	VectorXd _x;		// warm start
+};
+
+#endif //FEM_CONEINTEGRATOR_H
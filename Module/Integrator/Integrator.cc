@@ -3,8 +3,11 @@
 //
 
 #include "Integrator.h"
+#include "Util/Pattern.h"
 
 DEFINE_VIRTUAL_ACCESSIBLE_POINTER_MEMBER(IntegratorParameter, LCPSolverParameter, LCPSolverParameter)
 DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(IntegratorParameter, LCPSolverType, LCPSolverType)
 DEFINE_VIRTUAL_ACCESSIBLE_POINTER_MEMBER(IntegratorParameter, OptimizerParameter, OptimizerParameter)
-DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(IntegratorParameter, OptimizerType, OptimizerType)
\ No newline at end of file
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(IntegratorParameter, OptimizerType, OptimizerType)
+DEFINE_ACCESSIBLE_MEMBER(IntegratorParameter, int, AndersonWindow, _anderson_window)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(IntegratorParameter, std::string, RecordFile)
\ No newline at end of file
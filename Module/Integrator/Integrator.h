@@ -11,22 +11,31 @@
 #include "Contact/ContactGenerator.h"
 #include "Contact/FrictionModel.h"
 #include "BodyEnergy/BodyEnergy.h"
+#include <string>
 
 enum class IntegratorType {
 	kNonFrictionLCP,
-	kStaggeringLCP
+	kStaggeringLCP,
+	kCone
 };
 
 class IntegratorParameter {
 public:
+	/**
+	 * @param anderson_window history size of the Anderson acceleration on the
+	 * 		  fixed point iterations of the integrator, 0 for the plain iteration
+	 */
+	explicit IntegratorParameter(int anderson_window = 0) : _anderson_window(anderson_window) {}
+	IntegratorParameter(const IntegratorParameter& rhs) = default;
 	BASE_DECLARE_CLONE(IntegratorParameter);
+	virtual ~IntegratorParameter() = default;
 
 	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(LCPSolverType, LCPSolverType)
 	DECLARE_VIRTUAL_ACCESSIBLE_POINTER_MEMBER(LCPSolverParameter, LCPSolverParameter)
 	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(OptimizerType, OptimizerType)
 	DECLARE_VIRTUAL_ACCESSIBLE_POINTER_MEMBER(OptimizerParameter, OptimizerParameter)
-
-	virtual ~IntegratorParameter() = default;
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(std::string, RecordFile)
+	DECLARE_ACCESSIBLE_MEMBER(int, AndersonWindow, _anderson_window)
 };
 
 /**
@@ -41,8 +50,9 @@ public:
 	 * @param contact_generator Contact generator
 	 * @param friction_model Friction model
 	 * @param h Time step
+	 * @return whether the step is taken, the system is left as it is otherwise
 	 */
-	virtual void Step(System &system, const ContactGenerator &contact_generator,
+	virtual bool Step(System &system, const ContactGenerator &contact_generator,
 					  const FrictionModel &friction_model, double h) = 0;
 
 	virtual ~Integrator() = default;
@@ -10,12 +10,63 @@
 #include <Eigen/CholmodSupport>
 #include <spdlog/spdlog.h>
 #include <iostream>
+#include <limits>
 
 DEFINE_CLONE(IntegratorParameter, LCPIntegratorParameter)
 DEFINE_ACCESSIBLE_MEMBER(LCPIntegratorParameter, LCPSolverType, LCPSolverType, _lcp_type)
 DEFINE_ACCESSIBLE_POINTER_MEMBER(LCPIntegratorParameter, LCPSolverParameter, LCPSolverParameter, _lcp_para)
+DEFINE_ACCESSIBLE_MEMBER(LCPIntegratorParameter, std::string, RecordFile, _record_file)
 
 void LCPIntegrator::Initialize(const IntegratorParameter &para) {
 	_solver = LCPSolverFactory::GetInstance()->GetLCPSolver(para.GetLCPSolverType());
 	_solver->Initialize(*para.GetLCPSolverParameter());
-}
\ No newline at end of file
+	const auto& record_file = para.GetRecordFile();
+	if (!record_file.empty() && _recorder.Open(record_file)) {
+		spdlog::info("Recording LCP instances into {}", record_file);
+	}
+}
+
+void LCPIntegrator::Record(const MatrixXd &A, const VectorXd &b,
+						   const VectorXd &mu, const VectorXd &x0,
+						   int num_contact, int num_tangent,
+						   LCPFrictionType friction_type) {
+	if (!_recorder.IsOpen()) {
+		return;
+	}
+	LCPInstance instance;
+	instance._frame_id = _frame_id;
+	instance._num_contact = num_contact;
+	instance._num_tangent = num_tangent;
+	instance._friction_type = friction_type;
+	instance._A = A;
+	instance._b = b;
+	instance._mu = mu;
+	instance._x0 = x0;
+	_recorder.Record(instance);
+}
+
+void LCPIntegrator::Regularize(const char* name, MatrixXd &A, double compliance) {
+	const int size = A.rows();
+	if (compliance <= 0 || size == 0) {
+		return;
+	}
+	if (spdlog::should_log(spdlog::level::debug)) {
+		// A + cI shifts the spectrum of the symmetric A by c
+		Eigen::SelfAdjointEigenSolver<MatrixXd> eigen_solver(A, Eigen::EigenvaluesOnly);
+		const double min_eigen = eigen_solver.eigenvalues()(0);
+		const double max_eigen = eigen_solver.eigenvalues()(size - 1);
+		const double inf = std::numeric_limits<double>::infinity();
+		spdlog::debug("Conditioning of the {} block, spectrum [{}, {}] -> [{}, {}], condition number {} -> {}",
+					  name, min_eigen, max_eigen, min_eigen + compliance, max_eigen + compliance,
+					  min_eigen > 0 ? max_eigen / min_eigen : inf,
+					  min_eigen + compliance > 0 ? (max_eigen + compliance) / (min_eigen + compliance) : inf);
+	}
+	A.diagonal().array() += compliance;
+}
+
+void LCPIntegrator::AddGap(const vector<ContactPoint> &contacts, double h, VectorXd &b, int stride) {
+	const int num_contact = contacts.size();
+	for (int i = 0; i < num_contact; i++) {
+		b(i * stride) += contacts[i]._weight * contacts[i]._gap / h;
+	}
+}
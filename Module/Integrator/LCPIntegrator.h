@@ -6,17 +6,22 @@
 #define FEM_LCPINTEGRATOR_H
 
 #include "Integrator.h"
+#include "NumericSolver/LCPSolver/LCPRecorder.h"
 
 class LCPIntegratorParameter : public IntegratorParameter {
 public:
-	LCPIntegratorParameter(const LCPSolverType& lcp_type, const LCPSolverParameter& lcp_para)
-	: _lcp_type(lcp_type), _lcp_para(lcp_para.Clone()) {}
+	/**
+	 * @param record_file if not empty, the LCP of each step is dumped into it
+	 */
+	LCPIntegratorParameter(const LCPSolverType& lcp_type, const LCPSolverParameter& lcp_para, const std::string& record_file = "")
+	: _lcp_type(lcp_type), _lcp_para(lcp_para.Clone()), _record_file(record_file) {}
 
 	DERIVED_DECLARE_CLONE(IntegratorParameter)
 
-	LCPIntegratorParameter(const LCPIntegratorParameter& rhs) {
+	LCPIntegratorParameter(const LCPIntegratorParameter& rhs) : IntegratorParameter(rhs) {
 		_lcp_type = rhs._lcp_type;
 		_lcp_para = rhs.GetLCPSolverParameter()->Clone();
+		_record_file = rhs._record_file;
 	}
 
 	~LCPIntegratorParameter() override {
@@ -25,19 +30,45 @@ public:
 
 	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(LCPSolverType, LCPSolverType, _lcp_type)
 	DECLARE_OVERWRITE_ACCESSIBLE_POINTER_MEMBER(LCPSolverParameter, LCPSolverParameter, _lcp_para)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(std::string, RecordFile, _record_file)
 };
 
 class LCPIntegrator : public Integrator {
 public:
 	void Initialize(const IntegratorParameter &para) override;
-	void Step(System &system, const ContactGenerator &contact_generator,
+	bool Step(System &system, const ContactGenerator &contact_generator,
 			  const FrictionModel &friction_model, double h) override = 0;
 	virtual ~LCPIntegrator() {
 		delete _solver;
 	}
 
+	/**
+	 * Add the contact compliance to the diagonal of a block of the LCP,
+	 * the spectrum before and after is logged at debug level
+	 * @param name name of the block in the log
+	 */
+	static void Regularize(const char* name, MatrixXd &A, double compliance);
+
+	/**
+	 * Let the speculative contacts close their gaps within the step, the
+	 * normal rows become Jn u + weight * gap / h >= 0
+	 * @param b the constant term of the LCP, its normal rows being stride apart
+	 */
+	static void AddGap(const vector<ContactPoint> &contacts, double h, VectorXd &b, int stride = 1);
+
 protected:
+	/**
+	 * Dump the contact problem of the current step if recording is enabled
+	 * @param A the matrix of the problem, variables ordered as [normal, friction]
+	 * 		  for the polygonal friction and as (n, t1, t2) per contact for the cone
+	 */
+	void Record(const MatrixXd &A, const VectorXd &b, const VectorXd &mu,
+				const VectorXd &x0, int num_contact, int num_tangent,
+				LCPFrictionType friction_type = LCPFrictionType::kPolygon);
+
 	LCPSolver* _solver;
+	LCPRecorder _recorder;
+	int _frame_id = 0;
 };
 
 #endif //FEM_LCPINTEGRATOR_H
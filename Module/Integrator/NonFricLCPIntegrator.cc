@@ -7,7 +7,7 @@
 #include <Eigen/CholmodSupport>
 #include "Util/Timing.h"
 
-void NonFricLCPIntegrator::Step(System &system,
+bool NonFricLCPIntegrator::Step(System &system,
 								const ContactGenerator &contact_generator,
 								const FrictionModel &friction_model, double h) {
 //	const int num_tangent = contact_generator.GetNumTangent();
@@ -87,4 +87,5 @@ void NonFricLCPIntegrator::Step(System &system,
 //	VectorXd u_plus = Wic + WiJn * lambda_n + WiJt * lambda_t;
 //
 //	system.UpdateDynamic(u_plus, h);
+	return false;
 }
\ No newline at end of file
@@ -9,7 +9,7 @@
 
 class NonFricLCPIntegrator : public LCPIntegrator {
 public:
-	void Step(System &system, const ContactGenerator &contact_generator,
+	bool Step(System &system, const ContactGenerator &contact_generator,
 			  const FrictionModel &friction_model, double h) override;
 };
 
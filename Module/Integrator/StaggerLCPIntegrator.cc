@@ -8,14 +8,23 @@
 #include <spdlog/spdlog.h>
 #include "Util/Factory.h"
 #include "Util/Timing.h"
+#include "Util/Telemetry.h"
+#include "NumericSolver/LCPSolver/OSQPWrapper.h"
+
+DEFINE_CLONE(IntegratorParameter, StaggerLCPIntegratorParameter)
+
+StaggerLCPIntegrator::StaggerLCPIntegrator() = default;
+
+StaggerLCPIntegrator::~StaggerLCPIntegrator() = default;
 
 void StaggerLCPIntegrator::Initialize(const IntegratorParameter &para) {
 	LCPIntegrator::Initialize(para);
 	_max_step = para.GetLCPSolverParameter()->GetMaxStep();
 	_max_error = para.GetLCPSolverParameter()->GetMaxError();
+	_anderson.Initialize(para.GetAndersonWindow());
 }
 
-void StaggerLCPIntegrator::Step(System &system,
+bool StaggerLCPIntegrator::Step(System &system,
 								const ContactGenerator &contact_generator,
 								const FrictionModel &friction_model, double h) {
 	SparseMatrixXd JnT, JtT;
@@ -39,160 +48,168 @@ void StaggerLCPIntegrator::Step(System &system,
 	const int num_tangent = friction_model.GetNumTangent();
 
 	const int num_contact = JnT.rows();
+	const int num_friction = num_contact * num_tangent;
 	spdlog::info("Number of contact points: {}", num_contact);
 
-	int dof = system.GetSysDOF();	// dof for u, x, M and all such matrices
-	SparseMatrixXd W(dof, dof);
-
 	VectorXd u, f;
-	SparseMatrixXd mass = system.GetSysMass();
+	const SparseMatrixXd& mass = system.GetSysMass();
 	system.GetSysV(u);
 	system.GetSysF(f);
-	system.GetSysEnergyHessian(W);
+	system.GetSysEnergyHessian(_W);
 
 //	std::cerr << f.transpose() << std::endl;
 //	std::cerr << W.toDense() << std::endl;
 //	std::cerr << mass.toDense() << std::endl;
 
-	W *= h * h;
-	W += mass;
-	VectorXd c = mass * u + h * f;
+	_W *= h * h;
+	_W += mass;
+	_c.noalias() = mass * u;
+	_c += h * f;
 
 	START_TIMING(precompute_t)
 	Eigen::CholmodSupernodalLLT<SparseMatrixXd> LLT_solver;
-	LLT_solver.compute(W);
+	LLT_solver.compute(_W);
 	double alpha = 0.01;
+	int num_retry = 0;
 	while (LLT_solver.info() != Eigen::Success) {
 		spdlog::info("Making W SPD");
-		W += alpha * mass;
+		_W += alpha * mass;
+		TELEMETRY(Regularization("CHOLMOD", ++num_retry, alpha));
 		alpha *= 2;
-		LLT_solver.compute(W);
+		LLT_solver.compute(_W);
 	}
 	STOP_TIMING_TICK(precompute_t, "precomputing linear equations")
 
 	START_TIMING(solve_t)
-	MatrixXd WiJn = LLT_solver.solve(JnT.transpose().toDense());
-	MatrixXd WiJt = LLT_solver.solve(JtT.transpose().toDense());
-	VectorXd Wic = LLT_solver.solve(c);
+	_Jn = JnT.transpose();
+	_Jt = JtT.transpose();
+	_WiJn = LLT_solver.solve(_Jn);
+	_WiJt = LLT_solver.solve(_Jt);
+	_Wic = LLT_solver.solve(_c);
 	STOP_TIMING_TICK(solve_t, "solving linear equations")
 
+	_Ann.noalias() = JnT * _WiJn;
+	_Ant.noalias() = JnT * _WiJt;
+	_Atn.noalias() = JtT * _WiJn;
+	_Att.noalias() = JtT * _WiJt;
 
-	MatrixXd E(num_contact * num_tangent, num_contact);
-	E.setZero();
-	for (int i = 0; i < num_contact; i++) {
-		E.block(i * num_tangent, i, num_tangent, 1).setOnes();
-	}
+	// Compliant contacts, keeps the subproblems away from singular
+	const double compliance = friction_model.GetCompliance(h);
+	Regularize("normal", _Ann, compliance);
+	Regularize("friction", _Att, compliance);
 
-	MatrixXd Ann = JnT * WiJn, Ant = JnT * WiJt, Atn = JtT * WiJn, Att = JtT * WiJt;
-
-	SparseMatrixXd contact_hessian_sparse = Ann.sparseView();
-	SparseMatrixXd friction_hessian_sparse = Att.sparseView();
-
-	VectorXd bn = JnT * Wic;
-	VectorXd bt = JtT * Wic;
+	_bn.noalias() = JnT * _Wic;
+	_bt.noalias() = JtT * _Wic;
+	AddGap(contacts, h, _bn);
 
 //	std::cerr << "A: \n" << A << std::endl;
 //	std::cerr << "b: \n" << b.transpose() << std::endl;
 
-	static VectorXd xn(0), xt(0);
-	if (xn.size() != num_contact) {
-		xn.resize(num_contact);
-		xn.setZero();
-		xt.resize(num_contact * num_tangent);
-		xt.setZero();
+	if (_xn.size() != num_contact) {
+		_xn.setZero(num_contact);
+		_xt.setZero(num_friction);
+	}
+
+	if (num_contact != 0 && _recorder.IsOpen()) {
+		_A.resize(num_contact + num_friction, num_contact + num_friction);
+		_A << _Ann, _Ant, _Atn, _Att;
+		_b.resize(num_contact + num_friction);
+		_x0.resize(num_contact + num_friction);
+		_b << _bn, _bt;
+		_x0 << _xn, _xt;
+		Record(_A, _b, Mu, _x0, num_contact, num_tangent);
 	}
+	_frame_id++;
 
+	_num_steps = 0;
 	if (num_contact != 0) {
-		OsqpEigen::Solver contact_solver, friction_solver;
-		contact_solver.settings()->setWarmStart(true);
-		contact_solver.data()->setNumberOfVariables(num_contact);
-		contact_solver.data()->setNumberOfConstraints(num_contact);
-		contact_solver.data()->setHessianMatrix(contact_hessian_sparse);
-		SparseMatrixXd contact_constraint(num_contact, num_contact);
-		vector<Tripletd> contact_constraint_COO;
-		for (int i = 0; i < num_contact; i++) {
-			contact_constraint_COO.push_back(Tripletd(i, i, 1));
-		}
-		contact_constraint.setFromTriplets(contact_constraint_COO.begin(),
-										   contact_constraint_COO.end());
-		contact_solver.data()->setLinearConstraintsMatrix(contact_constraint);
-		VectorXd contact_lower_bound(num_contact), contact_upper_bound(
-				num_contact);
-		for (int i = 0; i < num_contact; i++) {
-			contact_lower_bound(i) = 0;
-			contact_upper_bound(i) = OsqpEigen::INFTY;
-		}
-		contact_solver.data()->setLowerBound(contact_lower_bound);
-		contact_solver.data()->setUpperBound(contact_upper_bound);
-		VectorXd contact_gradient = Ant * xt + bn;
-		contact_solver.data()->setGradient(contact_gradient);
-
-		const int friction_constraint_size = num_contact * (num_tangent + 1);
-		const int friction_variable_size = num_contact * num_tangent;
-		friction_solver.settings()->setWarmStart(true);
-		friction_solver.data()->setNumberOfVariables(friction_variable_size);
-		friction_solver.data()->setNumberOfConstraints(
-				friction_constraint_size);
-		friction_solver.data()->setHessianMatrix(friction_hessian_sparse);
-		SparseMatrixXd friction_constraint(friction_constraint_size,
-										   friction_variable_size);
-		vector<Tripletd> friction_constraint_COO;
-		for (int i = 0; i < friction_variable_size; i++) {
-			friction_constraint_COO.push_back(Tripletd(i, i, 1));
-		}
-		for (int i = 0; i < num_contact; i++) {
-			const int base_i = i + num_contact * num_tangent;
-			const int base_j = num_tangent * i;
-			for (int j = 0; j < num_tangent; j++) {
-				friction_constraint_COO.push_back(
-						Tripletd(base_i, base_j + j, -1));
+		// The normal subproblem is the LCP Ann xn + (bn + Ant xt) >= 0 with xn >= 0,
+		// left to the LCP solver of the integrator
+		const DenseLCPOperator contact_operator(_Ann);
+		_contact_gradient.resize(num_contact);
+
+		// The friction subproblem is the QP of Att with xt >= 0 and sum(xt) <= mu xn per contact
+		OSQPWrapper::ToFullPattern(_Att, _friction_hessian);
+		_friction_gradient.noalias() = _Atn * _xn;
+		_friction_gradient += _bt;
+		if (_friction_size != num_contact) {
+			const int friction_constraint_size = num_contact * (num_tangent + 1);
+			_friction_size = num_contact;
+
+			vector<Tripletd> friction_constraint_COO;
+			for (int i = 0; i < num_friction; i++) {
+				friction_constraint_COO.push_back(Tripletd(i, i, 1));
 			}
+			for (int i = 0; i < num_contact; i++) {
+				const int base_i = i + num_friction;
+				const int base_j = num_tangent * i;
+				for (int j = 0; j < num_tangent; j++) {
+					friction_constraint_COO.push_back(
+							Tripletd(base_i, base_j + j, -1));
+				}
+			}
+			_friction_constraint.resize(friction_constraint_size, num_friction);
+			_friction_constraint.setFromTriplets(friction_constraint_COO.begin(),
+												 friction_constraint_COO.end());
+			_friction_lower_bound.setZero(friction_constraint_size);
+			_friction_upper_bound.setConstant(friction_constraint_size, OsqpEigen::INFTY);
+			_friction_lower_bound.tail(num_contact) = -(Mu.asDiagonal() * _xn);
+
+			_friction_solver = std::make_unique<OsqpEigen::Solver>();
+			_friction_solver->settings()->setWarmStart(true);
+			// the staggering cannot settle below the accuracy of its subproblems
+			_friction_solver->settings()->setAbsoluteTolerance(_max_error);
+			_friction_solver->settings()->setRelativeTolerance(_max_error);
+			_friction_solver->data()->setNumberOfVariables(num_friction);
+			_friction_solver->data()->setNumberOfConstraints(friction_constraint_size);
+			_friction_solver->data()->setHessianMatrix(_friction_hessian);
+			_friction_solver->data()->setLinearConstraintsMatrix(_friction_constraint);
+			_friction_solver->data()->setLowerBound(_friction_lower_bound);
+			_friction_solver->data()->setUpperBound(_friction_upper_bound);
+			_friction_solver->data()->setGradient(_friction_gradient);
+			_friction_solver->initSolver();
+		} else {
+			_friction_solver->updateHessianMatrix(_friction_hessian);
 		}
-		friction_constraint.setFromTriplets(friction_constraint_COO.begin(),
-											friction_constraint_COO.end());
-		friction_solver.data()->setLinearConstraintsMatrix(friction_constraint);
-		VectorXd friction_lower_bound(
-				friction_constraint_size), friction_upper_bound(
-				friction_constraint_size);
-		for (int i = 0; i < friction_variable_size; i++) {
-			friction_lower_bound(i) = 0;
-			friction_upper_bound(i) = OsqpEigen::INFTY;
-		}
-		for (int i = friction_variable_size;
-			 i < friction_constraint_size; i++) {
-			friction_upper_bound(i) = OsqpEigen::INFTY;
-		}
-		friction_lower_bound.block(friction_variable_size, 0, num_contact,
-								   1) = -(Mu.asDiagonal() * xn);
-		friction_solver.data()->setLowerBound(friction_lower_bound);
-		friction_solver.data()->setUpperBound(friction_upper_bound);
-		VectorXd friction_gradient = Atn * xn + bt;
-		friction_solver.data()->setGradient(friction_gradient);
 
-		contact_solver.initSolver();
-		friction_solver.initSolver();
+		// The staggering iteration is a fixed point iteration on the stacked
+		// (xn, xt), the image of which is computed by the two subproblems
+		_x.resize(num_contact + num_friction);
+		_g.resize(num_contact + num_friction);
+		_x << _xn, _xt;
+		_anderson.Reset(_x.size());
 
 		int step = 0;
-		VectorXd pre_xn = xn, pre_xt = xt;
+		TelemetryScope telemetry("Staggering");
 		START_TIMING(t_iter)
 		while (step++ < _max_step) {
-			contact_solver.updateGradient(bn + Ant * xt);
-			contact_solver.solveProblem();
-			xn = contact_solver.getSolution();
-			friction_solver.updateGradient(bt + Atn * xn);
-			friction_lower_bound.block(friction_variable_size, 0, num_contact,
-									   1) = -(Mu.asDiagonal() * xn);
-			friction_solver.updateLowerBound(friction_lower_bound);
-			friction_solver.solveProblem();
-			xt = friction_solver.getSolution();
-			if ((xn - pre_xn).norm() < _max_error &&
-				(xt - pre_xt).norm() < _max_error) {
+			_contact_gradient.noalias() = _Ant * _x.tail(num_friction);
+			_contact_gradient += _bn;
+			_xn = _x.head(num_contact);
+			_solver->Solve(contact_operator, _contact_gradient, _xn);
+			_friction_gradient.noalias() = _Atn * _xn;
+			_friction_gradient += _bt;
+			_friction_solver->updateGradient(_friction_gradient);
+			_friction_lower_bound.tail(num_contact) = -(Mu.asDiagonal() * _xn);
+			_friction_solver->updateLowerBound(_friction_lower_bound);
+			_friction_solver->solveProblem();
+			_xt = _friction_solver->getSolution();
+			const double error_n = (_xn - _x.head(num_contact)).norm();
+			const double error_t = (_xt - _x.tail(num_friction)).norm();
+			TELEMETRY(Iteration("Staggering", step, std::max(error_n, error_t)));
+			if (error_n < _max_error && error_t < _max_error) {
 				break;
 			}
-			pre_xn = xn;
-			pre_xt = xt;
+			_g << _xn, _xt;
+			_anderson.Update(_x, _g);
+			if (_anderson.IsEnabled()) {
+				// The extrapolation may leave the feasible region
+				_x = _x.cwiseMax(0.0);
+			}
 		}
 		STOP_TIMING_TICK(t_iter, "Staggering iteration")
+		_num_steps = std::min(step, _max_step);
+		telemetry.Finish(_num_steps, step <= _max_step);
 		if (step <= _max_step) {
 			spdlog::info("Staggering Method, converges in {} steps", step);
 		} else {
@@ -206,8 +223,11 @@ void StaggerLCPIntegrator::Step(System &system,
 //	}
 
 	START_TIMING(update_t)
-	VectorXd u_plus = Wic + WiJn * xn + WiJt * xt;
+	_u_plus = _Wic;
+	_u_plus.noalias() += _WiJn * _xn;
+	_u_plus.noalias() += _WiJt * _xt;
 
-	system.UpdateDynamic(u_plus, h);
+	system.UpdateDynamic(_u_plus, h);
 	STOP_TIMING_TICK(update_t, "updating system")
-}
\ No newline at end of file
+	return true;
+}
@@ -6,16 +6,63 @@
 #define TEST_STAGGERLCPINTEGRATOR_H
 
 #include "LCPIntegrator.h"
+#include "NumericSolver/FixedPoint/AndersonAcceleration.h"
+#include <memory>
+
+namespace OsqpEigen {
+	class Solver;
+}
+
+class StaggerLCPIntegratorParameter : public LCPIntegratorParameter {
+public:
+	/**
+	 * @param anderson_window history size of the Anderson acceleration on the
+	 * 		  staggering iteration, 0 for the plain staggering iteration
+	 * @param record_file if not empty, the LCP of each step is dumped into it
+	 */
+	StaggerLCPIntegratorParameter(const LCPSolverType& lcp_type, const LCPSolverParameter& lcp_para, int anderson_window = 0, const std::string& record_file = "")
+	: LCPIntegratorParameter(lcp_type, lcp_para, record_file) {
+		_anderson_window = anderson_window;
+	}
+
+	DERIVED_DECLARE_CLONE(IntegratorParameter)
+};
 
 class StaggerLCPIntegrator : public LCPIntegrator {
 public:
+	StaggerLCPIntegrator();
+	~StaggerLCPIntegrator() override;
+
 	void Initialize(const IntegratorParameter &para) override;
-	void Step(System &system, const ContactGenerator &contact_generator,
+	bool Step(System &system, const ContactGenerator &contact_generator,
 			  const FrictionModel &friction_model, double h) override;
 
+	//-> Number of staggering iterations in the last step, 0 if there is no contact
+	int GetNumSteps() const {
+		return _num_steps;
+	}
+
 protected:
 	int _max_step;
 	double _max_error;
+	int _num_steps = 0;
+	AndersonAcceleration _anderson;
+
+	// Workspace of a step, resized only when the number of contacts changes
+	SparseMatrixXd _W;
+	MatrixXd _Jn, _Jt, _WiJn, _WiJt;
+	MatrixXd _Ann, _Ant, _Atn, _Att;
+	VectorXd _c, _Wic, _bn, _bt, _u_plus;
+	VectorXd _xn, _xt, _x, _g;	// the forces of the last step are the warm start
+	MatrixXd _A;
+	VectorXd _b, _x0;
+
+	// The friction subproblem, OSQP is only set up again when the number of contacts changes
+	std::unique_ptr<OsqpEigen::Solver> _friction_solver;
+	int _friction_size = -1;
+	SparseMatrixXd _friction_hessian, _friction_constraint;
+	VectorXd _contact_gradient, _friction_gradient;
+	VectorXd _friction_lower_bound, _friction_upper_bound;
 };
 
 #endif //TEST_STAGGERLCPINTEGRATOR_H
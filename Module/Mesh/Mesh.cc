@@ -204,6 +204,27 @@ void Mesh::CalculateSurface() {
 		_surface.row(surface_element_cnt++) = surface_ids;
 	}
 
+	// Interior points are left out of the compact surface
+	const int num_points = _points.size() / 3;
+	vector<int> compact_id(num_points, -1);
+	for (int i = 0; i < _surface.rows(); i++) {
+		for (int j = 0; j < 3; j++) {
+			compact_id[_surface(i, j)] = 0;
+		}
+	}
+	_surface_points.clear();
+	for (int i = 0; i < num_points; i++) {
+		if (compact_id[i] == 0) {
+			compact_id[i] = _surface_points.size();
+			_surface_points.push_back(i);
+		}
+	}
+	_compact_surface.resize(_surface.rows(), 3);
+	for (int i = 0; i < _surface.rows(); i++) {
+		for (int j = 0; j < 3; j++) {
+			_compact_surface(i, j) = compact_id[_surface(i, j)];
+		}
+	}
 }
 void Mesh::Store(const string &file) const {
 	fstream file_stream(file, std::ios::out | std::ios::trunc);
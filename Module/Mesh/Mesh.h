@@ -35,6 +35,16 @@ public:
 		return _surface;
 	}
 
+	//-> ids of the points on the surface, ascending
+	const vector<int>& GetSurfacePoints() const {
+		return _surface_points;
+	}
+
+	//-> the triangles of GetSurface, indexing into GetSurfacePoints instead
+	const Matrix<int, Dynamic, 3>& GetCompactSurface() const {
+		return _compact_surface;
+	}
+
 private:
 	/**
 	 * Load the mesh from vtk file
@@ -52,6 +62,8 @@ private:
 private:
 	Matrix<int, Dynamic, 3> _surface; // _surface[i][j] stores the jth vertex of
 									  // the ith surface primitive
+	vector<int> _surface_points;
+	Matrix<int, Dynamic, 3> _compact_surface;
 };
 
 #endif //FEM_MESH_H
@@ -0,0 +1,55 @@
+#include "AndersonAcceleration.h"
+
+void AndersonAcceleration::Initialize(int window) {
+	_window = std::max(window, 0);
+}
+
+void AndersonAcceleration::Reset(int size) {
+	_dF.resize(size, _window);
+	_dG.resize(size, _window);
+	_f.resize(size);
+	_f_pre.resize(size);
+	_g_pre.resize(size);
+	_num_history = 0;
+	_head = 0;
+	_has_pre = false;
+}
+
+double AndersonAcceleration::Update(VectorXd &x, const VectorXd &g) {
+	_f = g - x;
+	const double res = _f.norm();
+
+	if (_window == 0) {
+		x = g;
+		return res;
+	}
+
+	if (_has_pre) {
+		if (res > _res_pre) {
+			// Safeguard: the extrapolation made things worse, restart from
+			// the plain update
+			_num_history = 0;
+			_head = 0;
+		} else {
+			_dF.col(_head) = _f - _f_pre;
+			_dG.col(_head) = g - _g_pre;
+			_head = (_head + 1) % _window;
+			_num_history = std::min(_num_history + 1, _window);
+		}
+	}
+	_f_pre = _f;
+	_g_pre = g;
+	_res_pre = res;
+	_has_pre = true;
+
+	if (_num_history == 0) {
+		x = g;
+		return res;
+	}
+
+	// The order of the columns does not matter for the least square problem
+	const auto dF = _dF.leftCols(_num_history);
+	_gamma = dF.colPivHouseholderQr().solve(_f);
+	x = g - _dG.leftCols(_num_history) * _gamma;
+	return res;
+}
@@ -0,0 +1,48 @@
+#ifndef FEM_ANDERSONACCELERATION_H
+#define FEM_ANDERSONACCELERATION_H
+
+#include "Util/EigenAll.h"
+
+/**
+ * Anderson acceleration (type-II) for a fixed point iteration x <- G(x)
+ * The last _window differences of the residual f = G(x) - x and of G(x) are
+ * kept, the next iterate is the combination of the history minimizing the
+ * linearized residual. When the residual grows, the history is dropped and
+ * the plain update is used instead.
+ */
+class AndersonAcceleration {
+public:
+	/**
+	 * @param window size of the history, 0 for plain fixed point iteration
+	 */
+	void Initialize(int window);
+
+	/**
+	 * Clear the history, call this before a new fixed point iteration
+	 * @param size size of the iterate
+	 */
+	void Reset(int size);
+
+	/**
+	 * @param x INPUT & OUTPUT, the current iterate, overwritten by the next one
+	 * @param g INPUT, the image of x, namely G(x)
+	 * @return the norm of the residual G(x) - x
+	 */
+	double Update(VectorXd &x, const VectorXd &g);
+
+	bool IsEnabled() const {
+		return _window > 0;
+	}
+
+protected:
+	int _window = 0;
+	int _num_history = 0;	// number of valid columns in _dF and _dG
+	int _head = 0;			// the column to be overwritten next
+
+	MatrixXd _dF, _dG;		// differences of residuals and images
+	VectorXd _f, _f_pre, _g_pre, _gamma;
+	double _res_pre = 0;
+	bool _has_pre = false;
+};
+
+#endif //FEM_ANDERSONACCELERATION_H
@@ -0,0 +1,145 @@
+#include "AdaptiveLCPSolver.h"
+#include "Util/Factory.h"
+#include "PGS.h"
+#include "PivotingMethod.h"
+#include "OSQPWrapper.h"
+#include "BoxQP.h"
+#include <spdlog/spdlog.h>
+#include <chrono>
+
+DEFINE_CLONE(LCPSolverParameter, AdaptiveLCPSolverParameter)
+DEFINE_ACCESSIBLE_MEMBER(AdaptiveLCPSolverParameter, int, SmallSize, _small_size)
+DEFINE_ACCESSIBLE_MEMBER(AdaptiveLCPSolverParameter, int, LargeSize, _large_size)
+DEFINE_ACCESSIBLE_MEMBER(AdaptiveLCPSolverParameter, int, ExplorePeriod, _explore_period)
+
+namespace {
+	const double kDecay = 0.2;		// weight of the latest measurement in the moving average
+	const char* kBackendName[] = {"Pivot", "BoxQP", "OSQP", "PGS"};
+
+	int GroupOf(int size) {
+		int group = 0;
+		while (size > 1) {
+			size >>= 1;
+			group++;
+		}
+		return group;
+	}
+}
+
+void AdaptiveLCPSolver::Initialize(const LCPSolverParameter &para) {
+	LCPSolver::Initialize(para);
+	_small_size = para.GetSmallSize();
+	_large_size = para.GetLargeSize();
+	_explore_period = para.GetExplorePeriod();
+
+	for (auto backend : _backends) {
+		delete backend;
+	}
+	auto factory = LCPSolverFactory::GetInstance();
+	_backends[kPivot] = factory->GetLCPSolver(LCPSolverType::kPivot);
+	_backends[kPivot]->Initialize(PivotingMethodParameter(_max_step, _max_error));
+	_backends[kBoxQP] = factory->GetLCPSolver(LCPSolverType::kBoxQP);
+	_backends[kBoxQP]->Initialize(BoxQPParameter(_max_step, _max_error));
+	_backends[kOSQP] = factory->GetLCPSolver(LCPSolverType::kOSQP);
+	_backends[kOSQP]->Initialize(OSQPWrapperParameter(_max_step, _max_error));
+	_backends[kPGS] = factory->GetLCPSolver(LCPSolverType::kPGS);
+	_backends[kPGS]->Initialize(PGSParameter(_max_step, _max_error, 1));
+	_groups.clear();
+}
+
+int AdaptiveLCPSolver::Suggest(int size) const {
+	if (size < _small_size) {
+		return kPivot;
+	}
+	if (size < _large_size) {
+		return kBoxQP;
+	}
+	return kPGS;
+}
+
+int AdaptiveLCPSolver::Choose(int size, const Group &group) const {
+	// pivoting is cubic in the size, never try it on large problems
+	const int first = size < _large_size ? kPivot : kBoxQP;
+
+	int num_solve = 0;
+	for (int i = first; i < kNumBackend; i++) {
+		num_solve += group[i]._num_solve;
+	}
+	if (num_solve > 0 && _explore_period > 0 && num_solve % _explore_period == 0) {
+		int least = first;
+		for (int i = first; i < kNumBackend; i++) {
+			if (group[i]._num_solve < group[least]._num_solve) {
+				least = i;
+			}
+		}
+		return least;
+	}
+
+	const int suggested = Suggest(size);
+	if (group[suggested]._num_solve == 0) {
+		return suggested;
+	}
+	int fastest = suggested;
+	for (int i = first; i < kNumBackend; i++) {
+		if (group[i]._num_solve > 0 && group[i]._time < group[fastest]._time) {
+			fastest = i;
+		}
+	}
+	return fastest;
+}
+
+void AdaptiveLCPSolver::Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+							  Eigen::Ref<VectorXd> x, int block_size) const {
+	const int size = b.size();
+	const int group_id = GroupOf(size);
+	if (static_cast<int>(_groups.size()) <= group_id) {
+		_groups.resize(group_id + 1);
+	}
+	auto& group = _groups[group_id];
+
+	auto x0 = Reserve(_x0, size);
+	x0 = x;
+
+	const auto start = std::chrono::steady_clock::now();
+	const int chosen = Choose(size, group);
+	_backends[chosen]->Solve(A, b, x, block_size);
+	_converged = _backends[chosen]->IsConverged();
+	_num_iterations = _backends[chosen]->GetNumIterations();
+	_last_backend = chosen;
+
+	if (!_converged) {
+		group[chosen]._num_fail++;
+		spdlog::warn("{} fails on LCP of size {}, falling back", kBackendName[chosen], size);
+		// OSQP last, as it is the most robust one
+		for (int backend : {kPivot, kBoxQP, kPGS, kOSQP}) {
+			if (backend == chosen || (backend == kPivot && size >= _large_size)) {
+				continue;
+			}
+			x = x0;
+			_backends[backend]->Solve(A, b, x, block_size);
+			_num_iterations = _backends[backend]->GetNumIterations();
+			_last_backend = backend;
+			if (_backends[backend]->IsConverged()) {
+				_converged = true;
+				break;
+			}
+		}
+	}
+
+	// The time of the fallbacks is charged to the chosen backend
+	const double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	auto& statistics = group[chosen];
+	statistics._time = statistics._num_solve == 0 ? time : (1 - kDecay) * statistics._time + kDecay * time;
+	statistics._num_solve++;
+	spdlog::info("Adaptive LCP solver, size {}, {} in {}ms", size, kBackendName[chosen], time);
+}
+
+const char* AdaptiveLCPSolver::GetLastBackend() const {
+	return kBackendName[_last_backend];
+}
+
+AdaptiveLCPSolver::~AdaptiveLCPSolver() {
+	for (auto backend : _backends) {
+		delete backend;
+	}
+}
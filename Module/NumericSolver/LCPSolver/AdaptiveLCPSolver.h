@@ -0,0 +1,82 @@
+#ifndef FEM_ADAPTIVELCPSOLVER_H
+#define FEM_ADAPTIVELCPSOLVER_H
+
+#include "LCPSolver.h"
+#include <array>
+#include <vector>
+
+class AdaptiveLCPSolverParameter : public LCPSolverParameter {
+public:
+	/**
+	 * @param small_size problems smaller than this go to the pivoting method by default
+	 * @param large_size problems no smaller than this go to PGS by default,
+	 * 		  the ones in between go to the box QP solver
+	 * @param explore_period every explore_period solves of similar size, try
+	 * 		  the least measured backend instead of the fastest one
+	 */
+	AdaptiveLCPSolverParameter(int max_step, double max_error, int small_size = 20, int large_size = 200, int explore_period = 50)
+	: LCPSolverParameter(max_step, max_error), _small_size(small_size), _large_size(large_size), _explore_period(explore_period) {}
+
+	DERIVED_DECLARE_CLONE(LCPSolverParameter)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(int, SmallSize, _small_size)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(int, LargeSize, _large_size)
+	DECLARE_OVERWRITE_ACCESSIBLE_MEMBER(int, ExplorePeriod, _explore_period)
+};
+
+/**
+ * Dispatch each LCP to one of the pivoting method, the box QP solver, OSQP and PGS.
+ * Problems are grouped by the magnitude of their size, and for each group
+ * the solver keeps a moving average of the wall time of each backend,
+ * failures included. The fastest measured backend of the group is picked,
+ * and a backend failing to converge is followed by the others.
+ */
+class AdaptiveLCPSolver : public LCPSolver {
+public:
+	AdaptiveLCPSolver() = default;
+	AdaptiveLCPSolver(const AdaptiveLCPSolver&) = delete;
+
+	void Initialize(const LCPSolverParameter &para) override;
+	using LCPSolver::Solve;
+	void Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+			   Eigen::Ref<VectorXd> x, int block_size = 1) const override;
+
+	//-> Name of the backend which produced the last solution
+	const char* GetLastBackend() const;
+
+	~AdaptiveLCPSolver() override;
+
+protected:
+	enum Backend {
+		kPivot,
+		kBoxQP,
+		kOSQP,
+		kPGS,
+		kNumBackend
+	};
+
+	struct Statistics {
+		double _time = 0;		// moving average of the wall time in ms
+		int _num_solve = 0;
+		int _num_fail = 0;
+	};
+
+	typedef std::array<Statistics, kNumBackend> Group;
+
+	//-> the backend the size heuristic suggests
+	int Suggest(int size) const;
+
+	//-> the backend to try first for a problem of the given size
+	int Choose(int size, const Group &group) const;
+
+	int _small_size;
+	int _large_size;
+	int _explore_period;
+
+	std::array<LCPSolver*, kNumBackend> _backends{};
+
+	mutable std::vector<Group> _groups;	// indexed by log2 of the problem size
+	mutable VectorXd _x0;				// workspace for the warm start
+	mutable int _last_backend = kPGS;
+};
+
+#endif //FEM_ADAPTIVELCPSOLVER_H
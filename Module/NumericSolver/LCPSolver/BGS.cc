@@ -6,32 +6,41 @@
 #include "Util/Factory.h"
 #include "PivotingMethod.h"
 #include <spdlog/spdlog.h>
+#include "Util/Telemetry.h"
 
 DEFINE_CLONE(LCPSolverParameter, BGSParameter)
 
-VectorXd BGS::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
-					int block_size) const {
+void BGS::Initialize(const LCPSolverParameter &para) {
+	LCPSolver::Initialize(para);
+	delete _small_scale_solver;
+	_small_scale_solver = LCPSolverFactory::GetInstance()->GetLCPSolver(LCPSolverType::kPivot);
+	_small_scale_solver->Initialize(PivotingMethodParameter(_max_step, _max_error));
+}
+
+void BGS::Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+				Eigen::Ref<VectorXd> x, int block_size) const {
 	const int size = b.size();
 	const int num_block = size / block_size;
 
-	const auto& small_scale_solver = LCPSolverFactory::GetInstance()->GetLCPSolver(LCPSolverType::kPivot);
-	small_scale_solver->Initialize(PivotingMethodParameter(_max_step, _max_error));
-
-	VectorXd x = x0;
+	auto Aii = Reserve(_Aii, block_size, block_size);
+	auto bi = Reserve(_bi, block_size);
+	auto y = Reserve(_y, size);
+	TelemetryScope telemetry("BGS");
 
 	int step = 0;
 	while (step++ < _max_step) {
 		for (int i = 0; i < num_block; i++) {
-			VectorXd bi = b.block(i * block_size, 0, block_size, 1);
-			for (int j = 0; j < num_block; j++) {
-				if (j != i) {
-					bi += A.block(i * block_size, j * block_size, block_size, block_size)
-						  * x.block(j * block_size, 0, block_size, 1);
-				}
+			const int start = i * block_size;
+			// bi = b_i + sum_{j != i} A_ij x_j
+			for (int k = 0; k < block_size; k++) {
+				bi(k) = b(start + k) + A.RowDot(start + k, x);
 			}
-			x.block(i * block_size, 0, block_size, 1) = small_scale_solver->Solve(A.block(i * block_size, i * block_size, block_size, block_size), bi);
+			A.DiagonalBlock(start, block_size, Aii);
+			bi.noalias() -= Aii * x.segment(start, block_size);
+			_small_scale_solver->Solve(DenseLCPOperator(Aii), bi, x.segment(start, block_size));
 		}
-		VectorXd y = A * x + b;
+		A.Apply(x, y);
+		y += b;
 		bool y_positive = true;
 		for (int i = 0; i < size; i++) {
 			if (y(i) < 0) {
@@ -39,18 +48,22 @@ VectorXd BGS::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
 				break;
 			}
 		}
+		TELEMETRY(Iteration("BGS", step, y_positive ? x.dot(y) : -y.minCoeff()));
 		if (y_positive && x.dot(y) < _max_error) {
 			break;
 		}
 	}
 
+	_num_iterations = std::min(step, _max_step);
+	_converged = step < _max_step + 1;
+	telemetry.Finish(_num_iterations, _converged);
 	if (step < _max_step + 1) {
 		spdlog::info("BGS, converges in {} steps", step);
 	} else {
 		spdlog::warn("BGS, fail to converge");
 	}
+}
 
-	delete small_scale_solver;
-
-	return x;
-}
\ No newline at end of file
+BGS::~BGS() {
+	delete _small_scale_solver;
+}
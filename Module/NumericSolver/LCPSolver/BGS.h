@@ -15,7 +15,22 @@ public:
 
 class BGS : public LCPSolver {
 public:
-	VectorXd Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0, int block_size = 1) const override;
+	BGS() = default;
+	BGS(const BGS&) = delete;
+
+	void Initialize(const LCPSolverParameter &para) override;
+	using LCPSolver::Solve;
+	void Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+			   Eigen::Ref<VectorXd> x, int block_size = 1) const override;
+
+	~BGS() override;
+
+protected:
+	LCPSolver* _small_scale_solver = nullptr;	// solver for the diagonal blocks
+
+	mutable MatrixXd _Aii;		// workspace for the diagonal block
+	mutable VectorXd _bi;		// workspace for the constant term of the block
+	mutable VectorXd _y;		// workspace for Ax + b
 };
 
 #endif //FEM_BGS_H
@@ -0,0 +1,193 @@
+#include "BoxQP.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "Util/Telemetry.h"
+
+DEFINE_CLONE(LCPSolverParameter, BoxQPParameter)
+
+namespace {
+	// pivots of the Cholesky factor below this fraction of the diagonal of A
+	// are treated as singular
+	const double kSingular = 1e-10;
+}
+
+double BoxQP::ExtendFactor(int j) const {
+	const int m = _free.size();
+	auto l = _L.row(m).head(m);
+	for (int k = 0; k < m; k++) {
+		l(k) = _A(_free[k], j);
+	}
+	_L.topLeftCorner(m, m).triangularView<Eigen::Lower>().solveInPlace(l.transpose());
+	return _A(j, j) - l.squaredNorm();
+}
+
+bool BoxQP::AddFree(int j) const {
+	const int m = _free.size();
+	const double pivot = ExtendFactor(j);
+	if (!(pivot > kSingular * std::abs(_A(j, j)))) {
+		return false;
+	}
+	_L(m, m) = std::sqrt(pivot);
+	_free.push_back(j);
+	_is_free[j] = true;
+	return true;
+}
+
+void BoxQP::RemoveFree(int k) const {
+	const int m = _free.size();
+	_is_free[_free[k]] = false;
+	_free.erase(_free.begin() + k);
+	for (int i = k; i < m - 1; i++) {
+		_L.row(i).head(m) = _L.row(i + 1).head(m);
+	}
+	// The rows below k now stick out of the diagonal by one, rotate them back
+	for (int j = k; j < m - 1; j++) {
+		const double r = std::hypot(_L(j, j), _L(j, j + 1));
+		const double c = _L(j, j) / r, s = _L(j, j + 1) / r;
+		for (int i = j; i < m - 1; i++) {
+			const double u = _L(i, j), v = _L(i, j + 1);
+			_L(i, j) = c * u + s * v;
+			_L(i, j + 1) = -s * u + c * v;
+		}
+	}
+}
+
+void BoxQP::Solve(const LCPOperator &A_op, const Eigen::Ref<const VectorXd> &b,
+				  Eigen::Ref<VectorXd> x, int /*block_size*/) const {
+	const int size = b.size();
+	auto A = Reserve(_A, size, size);
+	A_op.ToDense(A);
+	auto y = Reserve(_y, size);
+	auto z = Reserve(_z, size);
+	Reserve(_L, size, size);
+	TelemetryScope telemetry("BoxQP");
+
+	// Warm start, the free set of the last solve joins the positive entries
+	if (static_cast<int>(_is_free.size()) != size) {
+		_is_free.assign(size, false);
+	}
+	x = x.cwiseMax(0.0);
+	_free.clear();
+	for (int i = 0; i < size; i++) {
+		if ((x(i) > 0 || _is_free[i]) && !AddFree(i)) {
+			// dependent on the free set, start it from the bound
+			_is_free[i] = false;
+			x(i) = 0;
+		}
+	}
+
+	int step = 0;
+	bool converged = false;
+	while (step++ < _max_step) {
+		// Minimize over the free set, with the rest fixed at 0
+		const int m = _free.size();
+		auto z_free = z.head(m);
+		for (int k = 0; k < m; k++) {
+			z_free(k) = -b(_free[k]);
+		}
+		const auto L = _L.topLeftCorner(m, m);
+		L.triangularView<Eigen::Lower>().solveInPlace(z_free);
+		L.transpose().triangularView<Eigen::Upper>().solveInPlace(z_free);
+
+		// Move towards the minimizer until some variable hits the bound
+		double alpha = 1;
+		int blocking = -1;
+		for (int k = 0; k < m; k++) {
+			const int i = _free[k];
+			if (z_free(k) < 0) {
+				const double t = x(i) / (x(i) - z_free(k));
+				if (t < alpha) {
+					alpha = t;
+					blocking = k;
+				}
+			}
+		}
+		for (int k = 0; k < m; k++) {
+			x(_free[k]) += alpha * (z_free(k) - x(_free[k]));
+		}
+		if (blocking != -1) {
+			x(_free[blocking]) = 0;
+			for (int k = m - 1; k >= 0; k--) {
+				if (x(_free[k]) <= 0) {
+					x(_free[k]) = 0;
+					RemoveFree(k);
+				}
+			}
+			continue;
+		}
+
+		// Optimal on the free set, free the most violated bound if any
+		y.noalias() = A * x;
+		y += b;
+		int j = -1;
+		double min_y = -_max_error;
+		for (int i = 0; i < size; i++) {
+			if (!_is_free[i] && y(i) < min_y) {
+				min_y = y(i);
+				j = i;
+			}
+		}
+		TELEMETRY(Iteration("BoxQP", step, j == -1 ? 0.0 : -min_y));
+		if (j == -1) {
+			converged = true;
+			break;
+		}
+		if (AddFree(j)) {
+			continue;
+		}
+
+		// A(free + j, free + j) is singular, along d = (-A(free, free)^-1 A(free, j), 1)
+		// the objective decreases with slope y(j), follow it to the bound
+		auto d_free = z.head(m);
+		d_free = -_L.row(m).head(m).transpose();
+		L.transpose().triangularView<Eigen::Upper>().solveInPlace(d_free);
+		double t = std::numeric_limits<double>::infinity();
+		blocking = -1;
+		for (int k = 0; k < m; k++) {
+			if (d_free(k) < 0 && x(_free[k]) / -d_free(k) < t) {
+				t = x(_free[k]) / -d_free(k);
+				blocking = k;
+			}
+		}
+		if (blocking == -1) {
+			spdlog::error("Box QP, unbounded along variable {}", j);
+			break;
+		}
+		for (int k = 0; k < m; k++) {
+			x(_free[k]) += t * d_free(k);
+		}
+		x(_free[blocking]) = 0;
+		for (int k = m - 1; k >= 0; k--) {
+			if (x(_free[k]) <= 0) {
+				x(_free[k]) = 0;
+				RemoveFree(k);
+			}
+		}
+		x(j) = t;
+		if (!AddFree(j)) {
+			spdlog::error("Box QP, singular pivot at variable {}", j);
+			break;
+		}
+	}
+
+	if (converged) {
+		// y vanishes on the free set only if A is symmetric
+		for (int i : _free) {
+			if (std::abs(y(i)) > _max_error) {
+				converged = false;
+				break;
+			}
+		}
+	}
+
+	_num_iterations = std::min(step, _max_step);
+	_converged = converged;
+	telemetry.Finish(_num_iterations, _converged);
+	if (converged) {
+		spdlog::info("Box QP, converges in {} steps", step);
+	} else {
+		spdlog::warn("Box QP, fail to converge, steps: {}", step);
+	}
+}
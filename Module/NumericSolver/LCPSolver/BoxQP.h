@@ -0,0 +1,58 @@
+#ifndef FEM_BOXQP_H
+#define FEM_BOXQP_H
+
+#include "LCPSolver.h"
+#include <vector>
+
+class BoxQPParameter : public LCPSolverParameter {
+public:
+	BoxQPParameter(int max_step, double max_error) : LCPSolverParameter(max_step, max_error) {}
+
+	DERIVED_DECLARE_CLONE(LCPSolverParameter)
+};
+
+/**
+ * Active set method for min 1/2 x^T A x + b^T x, s.t. x >= 0, which is the
+ * LCP of a symmetric positive (semi-)definite A. Each iteration moves one
+ * variable in or out of the free set and updates the Cholesky factor of A
+ * restricted to the free set accordingly. The free set starts from the
+ * positive entries of the warm start and the free set of the last solve.
+ * When freeing a variable makes A(free, free) singular, the objective is
+ * linear along the null direction and the iterate moves along it until a
+ * free variable hits the bound, which is then fixed instead.
+ * @note For nonsymmetric A the result is checked against the LCP and the
+ * 		 solve is reported as not converged if it fails.
+ */
+class BoxQP : public LCPSolver {
+public:
+	using LCPSolver::Solve;
+	void Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+			   Eigen::Ref<VectorXd> x, int block_size = 1) const override;
+
+protected:
+	/**
+	 * Compute the new row l of the Cholesky factor for appending variable j,
+	 * stored right below the current factor
+	 * @return the square of the new pivot, A(j, j) - l^T l
+	 */
+	double ExtendFactor(int j) const;
+
+	/**
+	 * Append variable j to the free set and the Cholesky factor
+	 * @return false if the pivot is singular, then j is not appended, but the
+	 * 		   row computed by ExtendFactor is left below the factor
+	 */
+	bool AddFree(int j) const;
+
+	//-> remove the kth variable of the free set from the free set and the Cholesky factor
+	void RemoveFree(int k) const;
+
+	// Workspace
+	mutable MatrixXd _A;				// dense copy of A
+	mutable MatrixXd _L;				// Cholesky factor of A(free, free), top left corner
+	mutable VectorXd _y, _z;
+	mutable std::vector<int> _free;		// the free set, in the order of _L
+	mutable std::vector<char> _is_free;	// kept between solves as the warm start
+};
+
+#endif //FEM_BOXQP_H
@@ -0,0 +1,86 @@
+#include "ConePGS.h"
+#include <spdlog/spdlog.h>
+#include "Util/Telemetry.h"
+
+void ConePGS::Initialize(const LCPSolverParameter &para) {
+	_max_step = para.GetMaxStep();
+	_max_error = para.GetMaxError();
+}
+
+void ConePGS::Project(double mu, Eigen::Ref<Eigen::Vector3d> x) {
+	const double n = x(0);
+	const double t = x.tail<2>().norm();
+	if (t <= mu * n) {
+		// inside the cone
+		return;
+	}
+	if (mu * t <= -n) {
+		// inside the polar cone
+		x.setZero();
+		return;
+	}
+	const double n_projected = (n + mu * t) / (1 + mu * mu);
+	x(0) = n_projected;
+	x.tail<2>() *= mu * n_projected / t;
+}
+
+void ConePGS::Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+					const Eigen::Ref<const VectorXd> &mu, Eigen::Ref<VectorXd> x) const {
+	const int size = b.size();
+	const int num_contact = size / 3;
+	if (_y.size() < size) {
+		_y.resize(size);
+	}
+	auto y = _y.head(size);
+	TelemetryScope telemetry("ConePGS");
+
+	for (int i = 0; i < num_contact; i++) {
+		Project(mu(i), x.segment<3>(3 * i));
+	}
+
+	Eigen::Vector3d y_i, x_i;
+	int step = 0;
+	while (step++ < _max_step) {
+		for (int i = 0; i < num_contact; i++) {
+			const int base = 3 * i;
+			double trace = 0;
+			for (int j = 0; j < 3; j++) {
+				y_i(j) = A.RowDot(base + j, x) + b(base + j);
+				trace += A.Diagonal(base + j);
+			}
+			if (trace < _max_error) {
+				spdlog::error("Zero diagonal block at contact {}!", i);
+				_num_iterations = step;
+				_converged = false;
+				telemetry.Finish(_num_iterations, _converged);
+				return;
+			}
+			x.segment<3>(base) -= 3 / trace * y_i;
+			Project(mu(i), x.segment<3>(base));
+		}
+
+		// residual of the natural map, x - P_K(x - y)
+		A.Apply(x, y);
+		y += b;
+		double residual = 0;
+		for (int i = 0; i < num_contact; i++) {
+			x_i = x.segment<3>(3 * i) - y.segment<3>(3 * i);
+			Project(mu(i), x_i);
+			residual = std::max(residual, (x.segment<3>(3 * i) - x_i).cwiseAbs().maxCoeff());
+		}
+		TELEMETRY(Iteration("ConePGS", step, residual));
+		// a stalled sweep is not a solution
+		if (residual < _max_error) {
+			break;
+		}
+	}
+
+	_num_iterations = std::min(step, _max_step);
+	_converged = step <= _max_step;
+	telemetry.Finish(_num_iterations, _converged);
+	if (_converged) {
+		spdlog::info("Cone PGS, converges in {} steps", step);
+	} else {
+		spdlog::warn("Cone PGS, fail to converge, steps: {}", step);
+	}
+}
@@ -0,0 +1,52 @@
+#ifndef FEM_CONEPGS_H
+#define FEM_CONEPGS_H
+
+#include "LCPSolver.h"
+
+/**
+ * Blocked projected Gauss-Seidel for the cone complementarity problem
+ * 		x_i in K_i, y_i in K_i^*, x_i^T y_i = 0, with y = Ax + b
+ * where each block x_i = (n, t1, t2) belongs to a contact,
+ * K_i = {||t|| <= mu_i n} is its friction cone and K_i^* = {mu_i ||t|| <= n}
+ * the dual cone. Each block is updated by
+ * 		x_i <- P_K(x_i - gamma_i y_i), gamma_i = 3 / trace(A_ii)
+ * whose fixed points are the solutions for any positive gamma_i.
+ */
+class ConePGS {
+public:
+	//-> only the maximum step and the maximum error are used
+	void Initialize(const LCPSolverParameter &para);
+
+	/**
+	 * @param A INPUT, the operator, variables ordered as (n, t1, t2) per contact
+	 * @param b INPUT, the constant term
+	 * @param mu INPUT, coefficients of friction of the contacts
+	 * @param x INPUT & OUTPUT, the warm start on input and the solution on output
+	 */
+	void Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+			   const Eigen::Ref<const VectorXd> &mu, Eigen::Ref<VectorXd> x) const;
+
+	//-> Number of iterations spent in the last solve
+	int GetNumIterations() const {
+		return _num_iterations;
+	}
+
+	//-> Whether the last solve reached the tolerance
+	bool IsConverged() const {
+		return _converged;
+	}
+
+	//-> project x = (n, t1, t2) onto the cone ||t|| <= mu n
+	static void Project(double mu, Eigen::Ref<Eigen::Vector3d> x);
+
+protected:
+	int _max_step;
+	double _max_error;
+
+	mutable int _num_iterations = -1;
+	mutable bool _converged = true;
+
+	mutable VectorXd _y;	// workspace for Ax + b
+};
+
+#endif //FEM_CONEPGS_H
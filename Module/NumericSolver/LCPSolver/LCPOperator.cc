@@ -0,0 +1,222 @@
+#include "LCPOperator.h"
+#include <type_traits>
+#include <algorithm>
+
+namespace {
+	//-> The top left (rows x cols) block of buffer, buffer grows if it is too small
+	Eigen::Block<MatrixXf> ReserveDense(MatrixXf &buffer, int rows, int cols) {
+		if (buffer.rows() < rows || buffer.cols() < cols) {
+			buffer.resize(std::max<int>(rows, buffer.rows()), std::max<int>(cols, buffer.cols()));
+		}
+		return buffer.topLeftCorner(rows, cols);
+	}
+
+	//-> Round A into the top left block of buffer, returns whether the block moved
+	template<class Derived>
+	bool RoundDense(const Eigen::MatrixBase<Derived> &A, MatrixXf &buffer) {
+		const float* data = buffer.data();
+		const Eigen::Index stride = buffer.rows();
+		ReserveDense(buffer, A.rows(), A.cols()) = A.template cast<float>();
+		return buffer.data() != data || buffer.rows() != stride;
+	}
+
+	//-> Round A into buffer, only the values are copied if the pattern is unchanged
+	template<class Scalar>
+	void RoundSparse(const RowSparseMatrixX<Scalar> &A, RowSparseMatrixXf &buffer) {
+		const int nnz = A.nonZeros();
+		if (A.isCompressed() && buffer.isCompressed() && buffer.rows() == A.rows()
+			&& buffer.cols() == A.cols() && buffer.nonZeros() == nnz
+			&& std::equal(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1, buffer.outerIndexPtr())
+			&& std::equal(A.innerIndexPtr(), A.innerIndexPtr() + nnz, buffer.innerIndexPtr())) {
+			Eigen::Map<VectorXf>(buffer.valuePtr(), nnz) = Eigen::Map<const VectorX<Scalar>>(A.valuePtr(), nnz).template cast<float>();
+		} else {
+			buffer = A.template cast<float>();
+			buffer.makeCompressed();
+		}
+	}
+
+	//-> Whether the operator in buffer is an Operator of the given size, which can be reused
+	template<class Operator>
+	bool IsRounded(const LCPRoundingBuffer &buffer, int size) {
+		const auto rounded = dynamic_cast<const Operator*>(buffer._rounded.get());
+		return rounded != nullptr && rounded->Size() == size;
+	}
+}
+
+template<class Scalar>
+int BasicDenseLCPOperator<Scalar>::Size() const {
+	return _A.rows();
+}
+
+template<class Scalar>
+void BasicDenseLCPOperator<Scalar>::Apply(const Eigen::Ref<const Vector> &x,
+							 Eigen::Ref<Vector> y) const {
+	y.noalias() = _A * x;
+}
+
+template<class Scalar>
+Scalar BasicDenseLCPOperator<Scalar>::RowDot(int i, const Eigen::Ref<const Vector> &x) const {
+	return _A.row(i).dot(x);
+}
+
+template<class Scalar>
+Scalar BasicDenseLCPOperator<Scalar>::Diagonal(int i) const {
+	return _A(i, i);
+}
+
+template<class Scalar>
+void BasicDenseLCPOperator<Scalar>::DiagonalBlock(int start, int size,
+									 Eigen::Ref<Matrix> block) const {
+	block = _A.block(start, start, size, size);
+}
+
+template<class Scalar>
+void BasicDenseLCPOperator<Scalar>::ToDense(Eigen::Ref<Matrix> A) const {
+	A = _A;
+}
+
+template<class Scalar>
+const BasicLCPOperator<float>& BasicDenseLCPOperator<Scalar>::Round(LCPRoundingBuffer &buffer) const {
+	if constexpr (std::is_same_v<Scalar, float>) {
+		return *this;
+	} else {
+		const int size = _A.rows();
+		if (RoundDense(_A, buffer._dense) || !IsRounded<BasicDenseLCPOperator<float>>(buffer, size)) {
+			buffer._rounded = std::make_unique<BasicDenseLCPOperator<float>>(buffer._dense.topLeftCorner(size, size));
+		}
+		return *buffer._rounded;
+	}
+}
+
+template<class Scalar>
+int BasicSparseLCPOperator<Scalar>::Size() const {
+	return _A.rows();
+}
+
+template<class Scalar>
+void BasicSparseLCPOperator<Scalar>::Apply(const Eigen::Ref<const Vector> &x,
+							  Eigen::Ref<Vector> y) const {
+	y.noalias() = _A * x;
+}
+
+template<class Scalar>
+Scalar BasicSparseLCPOperator<Scalar>::RowDot(int i, const Eigen::Ref<const Vector> &x) const {
+	Scalar dot = 0;
+	for (typename RowSparseMatrixX<Scalar>::InnerIterator it(_A, i); it; ++it) {
+		dot += it.value() * x(it.col());
+	}
+	return dot;
+}
+
+template<class Scalar>
+Scalar BasicSparseLCPOperator<Scalar>::Diagonal(int i) const {
+	return _A.coeff(i, i);
+}
+
+template<class Scalar>
+void BasicSparseLCPOperator<Scalar>::DiagonalBlock(int start, int size,
+									  Eigen::Ref<Matrix> block) const {
+	block.setZero();
+	for (int i = 0; i < size; i++) {
+		for (typename RowSparseMatrixX<Scalar>::InnerIterator it(_A, start + i); it; ++it) {
+			if (it.col() >= start && it.col() < start + size) {
+				block(i, it.col() - start) = it.value();
+			}
+		}
+	}
+}
+
+template<class Scalar>
+void BasicSparseLCPOperator<Scalar>::ToDense(Eigen::Ref<Matrix> A) const {
+	A.setZero();
+	for (int i = 0; i < _A.outerSize(); i++) {
+		for (typename RowSparseMatrixX<Scalar>::InnerIterator it(_A, i); it; ++it) {
+			A(i, it.col()) = it.value();
+		}
+	}
+}
+
+template<class Scalar>
+const BasicLCPOperator<float>& BasicSparseLCPOperator<Scalar>::Round(LCPRoundingBuffer &buffer) const {
+	if constexpr (std::is_same_v<Scalar, float>) {
+		return *this;
+	} else {
+		RoundSparse(_A, buffer._sparse);
+		if (!IsRounded<BasicSparseLCPOperator<float>>(buffer, _A.rows())) {
+			buffer._rounded = std::make_unique<BasicSparseLCPOperator<float>>(buffer._sparse);
+		}
+		return *buffer._rounded;
+	}
+}
+
+template<class Scalar>
+int BasicFactoredLCPOperator<Scalar>::Size() const {
+	return _L.rows();
+}
+
+template<class Scalar>
+void BasicFactoredLCPOperator<Scalar>::Apply(const Eigen::Ref<const Vector> &x,
+								Eigen::Ref<Vector> y) const {
+	// Row by row, as L is much sparser than R is tall
+	const int size = _L.rows();
+	for (int i = 0; i < size; i++) {
+		y(i) = RowDot(i, x);
+	}
+}
+
+template<class Scalar>
+Scalar BasicFactoredLCPOperator<Scalar>::RowDot(int i, const Eigen::Ref<const Vector> &x) const {
+	Scalar dot = 0;
+	for (typename RowSparseMatrixX<Scalar>::InnerIterator it(_L, i); it; ++it) {
+		dot += it.value() * _R.row(it.col()).dot(x);
+	}
+	return dot;
+}
+
+template<class Scalar>
+Scalar BasicFactoredLCPOperator<Scalar>::Diagonal(int i) const {
+	Scalar diagonal = 0;
+	for (typename RowSparseMatrixX<Scalar>::InnerIterator it(_L, i); it; ++it) {
+		diagonal += it.value() * _R(it.col(), i);
+	}
+	return diagonal;
+}
+
+template<class Scalar>
+void BasicFactoredLCPOperator<Scalar>::DiagonalBlock(int start, int size,
+										Eigen::Ref<Matrix> block) const {
+	block.setZero();
+	for (int i = 0; i < size; i++) {
+		for (typename RowSparseMatrixX<Scalar>::InnerIterator it(_L, start + i); it; ++it) {
+			block.row(i) += it.value() * _R.row(it.col()).segment(start, size);
+		}
+	}
+}
+
+template<class Scalar>
+void BasicFactoredLCPOperator<Scalar>::ToDense(Eigen::Ref<Matrix> A) const {
+	A.noalias() = _L * _R;
+}
+
+template<class Scalar>
+const BasicLCPOperator<float>& BasicFactoredLCPOperator<Scalar>::Round(LCPRoundingBuffer &buffer) const {
+	if constexpr (std::is_same_v<Scalar, float>) {
+		return *this;
+	} else {
+		// the view on R is kept if neither its shape nor its storage changes
+		const bool reshaped = buffer._sparse.cols() != _L.cols();
+		RoundSparse(_L, buffer._sparse);
+		if (RoundDense(_R, buffer._dense) || reshaped || !IsRounded<BasicFactoredLCPOperator<float>>(buffer, _L.rows())) {
+			buffer._rounded = std::make_unique<BasicFactoredLCPOperator<float>>(
+				buffer._sparse, buffer._dense.topLeftCorner(_R.rows(), _R.cols()));
+		}
+		return *buffer._rounded;
+	}
+}
+
+template class BasicDenseLCPOperator<double>;
+template class BasicDenseLCPOperator<float>;
+template class BasicSparseLCPOperator<double>;
+template class BasicSparseLCPOperator<float>;
+template class BasicFactoredLCPOperator<double>;
+template class BasicFactoredLCPOperator<float>;
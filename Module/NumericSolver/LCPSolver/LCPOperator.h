@@ -0,0 +1,133 @@
+#ifndef FEM_LCPOPERATOR_H
+#define FEM_LCPOPERATOR_H
+
+#include "Util/EigenAll.h"
+#include <memory>
+
+template<class Scalar>
+using RowSparseMatrixX = Eigen::SparseMatrix<Scalar, Eigen::RowMajor>;
+typedef RowSparseMatrixX<double> RowSparseMatrixXd;
+typedef RowSparseMatrixX<float> RowSparseMatrixXf;
+
+struct LCPRoundingBuffer;
+
+/**
+ * The linear operator A of an LCP. Solvers only access A through this
+ * interface, so A can be dense, sparse or never formed at all.
+ * None of the methods allocate, except Round when the shape changes.
+ * Instantiated for double and float, the latter halves the memory traffic
+ * of the sweeps at the cost of precision.
+ */
+template<class Scalar>
+class BasicLCPOperator {
+public:
+	typedef VectorX<Scalar> Vector;
+	typedef MatrixX<Scalar> Matrix;
+
+	virtual int Size() const = 0;
+
+	//-> y = Ax
+	virtual void Apply(const Eigen::Ref<const Vector> &x, Eigen::Ref<Vector> y) const = 0;
+
+	//-> the dot product of the ith row of A and x
+	virtual Scalar RowDot(int i, const Eigen::Ref<const Vector> &x) const = 0;
+
+	//-> A(i, i)
+	virtual Scalar Diagonal(int i) const = 0;
+
+	//-> A(start : start + size, start : start + size)
+	virtual void DiagonalBlock(int start, int size, Eigen::Ref<Matrix> block) const = 0;
+
+	//-> write A into a (Size() x Size()) matrix, for solvers requiring the whole matrix
+	virtual void ToDense(Eigen::Ref<Matrix> A) const = 0;
+
+	//-> A in single precision with the same structure, stored in buffer
+	virtual const BasicLCPOperator<float>& Round(LCPRoundingBuffer &buffer) const = 0;
+
+	virtual ~BasicLCPOperator() = default;
+};
+
+template<class Scalar>
+class BasicDenseLCPOperator : public BasicLCPOperator<Scalar> {
+public:
+	typedef typename BasicLCPOperator<Scalar>::Vector Vector;
+	typedef typename BasicLCPOperator<Scalar>::Matrix Matrix;
+
+	explicit BasicDenseLCPOperator(const Eigen::Ref<const Matrix> &A) : _A(A) {}
+
+	int Size() const override;
+	void Apply(const Eigen::Ref<const Vector> &x, Eigen::Ref<Vector> y) const override;
+	Scalar RowDot(int i, const Eigen::Ref<const Vector> &x) const override;
+	Scalar Diagonal(int i) const override;
+	void DiagonalBlock(int start, int size, Eigen::Ref<Matrix> block) const override;
+	void ToDense(Eigen::Ref<Matrix> A) const override;
+	const BasicLCPOperator<float>& Round(LCPRoundingBuffer &buffer) const override;
+
+protected:
+	const Eigen::Ref<const Matrix> _A;
+};
+
+template<class Scalar>
+class BasicSparseLCPOperator : public BasicLCPOperator<Scalar> {
+public:
+	typedef typename BasicLCPOperator<Scalar>::Vector Vector;
+	typedef typename BasicLCPOperator<Scalar>::Matrix Matrix;
+
+	explicit BasicSparseLCPOperator(const RowSparseMatrixX<Scalar> &A) : _A(A) {}
+
+	int Size() const override;
+	void Apply(const Eigen::Ref<const Vector> &x, Eigen::Ref<Vector> y) const override;
+	Scalar RowDot(int i, const Eigen::Ref<const Vector> &x) const override;
+	Scalar Diagonal(int i) const override;
+	void DiagonalBlock(int start, int size, Eigen::Ref<Matrix> block) const override;
+	void ToDense(Eigen::Ref<Matrix> A) const override;
+	const BasicLCPOperator<float>& Round(LCPRoundingBuffer &buffer) const override;
+
+protected:
+	const RowSparseMatrixX<Scalar> &_A;
+};
+
+/**
+ * A = L * R without forming A, where L is sparse and R is dense, which is
+ * exactly the shape of the Delassus operator J * (W^-1 J^T)
+ */
+template<class Scalar>
+class BasicFactoredLCPOperator : public BasicLCPOperator<Scalar> {
+public:
+	typedef typename BasicLCPOperator<Scalar>::Vector Vector;
+	typedef typename BasicLCPOperator<Scalar>::Matrix Matrix;
+
+	BasicFactoredLCPOperator(const RowSparseMatrixX<Scalar> &L, const Eigen::Ref<const Matrix> &R)
+	: _L(L), _R(R) {}
+
+	int Size() const override;
+	void Apply(const Eigen::Ref<const Vector> &x, Eigen::Ref<Vector> y) const override;
+	Scalar RowDot(int i, const Eigen::Ref<const Vector> &x) const override;
+	Scalar Diagonal(int i) const override;
+	void DiagonalBlock(int start, int size, Eigen::Ref<Matrix> block) const override;
+	void ToDense(Eigen::Ref<Matrix> A) const override;
+	const BasicLCPOperator<float>& Round(LCPRoundingBuffer &buffer) const override;
+
+protected:
+	const RowSparseMatrixX<Scalar> &_L;
+	const Eigen::Ref<const Matrix> _R;
+};
+
+typedef BasicLCPOperator<double> LCPOperator;
+typedef BasicDenseLCPOperator<double> DenseLCPOperator;
+typedef BasicSparseLCPOperator<double> SparseLCPOperator;
+typedef BasicFactoredLCPOperator<double> FactoredLCPOperator;
+
+/**
+ * Storage of the single precision copy of an operator. The dense storage
+ * only grows, so rounding operators of similar sizes does not reallocate it.
+ * Rounding an operator of the same kind and shape again only refills the
+ * values and reuses _rounded.
+ */
+struct LCPRoundingBuffer {
+	MatrixXf _dense;
+	RowSparseMatrixXf _sparse;
+	std::unique_ptr<BasicLCPOperator<float>> _rounded;
+};
+
+#endif //FEM_LCPOPERATOR_H
@@ -0,0 +1,97 @@
+#include "LCPRecorder.h"
+#include <spdlog/spdlog.h>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+	const char kMagic[4] = {'L', 'C', 'P', '2'};
+
+	template<typename T>
+	void Write(std::ofstream &output, const T &value) {
+		output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	bool Read(std::ifstream &input, T &value) {
+		return (bool) input.read(reinterpret_cast<char*>(&value), sizeof(T));
+	}
+
+	void WriteVector(std::ofstream &output, const VectorXd &v) {
+		output.write(reinterpret_cast<const char*>(v.data()), sizeof(double) * v.size());
+	}
+
+	bool ReadVector(std::ifstream &input, VectorXd &v, int size) {
+		v.resize(size);
+		return (bool) input.read(reinterpret_cast<char*>(v.data()), sizeof(double) * size);
+	}
+}
+
+bool LCPRecorder::Open(const std::string &file) {
+	_output.open(file, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!_output.is_open()) {
+		spdlog::error("Cannot open {} to record LCP instances", file);
+		return false;
+	}
+	_output.write(kMagic, sizeof(kMagic));
+	return true;
+}
+
+bool LCPRecorder::IsOpen() const {
+	return _output.is_open();
+}
+
+void LCPRecorder::Record(const LCPInstance &instance) {
+	const int32_t size = instance._b.size();
+	Write<int32_t>(_output, instance._frame_id);
+	Write<int32_t>(_output, instance._num_contact);
+	Write<int32_t>(_output, instance._num_tangent);
+	Write<int32_t>(_output, static_cast<int32_t>(instance._friction_type));
+	Write<int32_t>(_output, size);
+	for (int i = 0; i < size; i++) {
+		for (int j = i; j < size; j++) {
+			Write<double>(_output, instance._A(i, j));
+		}
+	}
+	WriteVector(_output, instance._b);
+	WriteVector(_output, instance._mu);
+	WriteVector(_output, instance._x0);
+	_output.flush();
+}
+
+void LCPRecorder::Close() {
+	_output.close();
+}
+
+bool LCPReader::Open(const std::string &file) {
+	_input.open(file, std::ios::in | std::ios::binary);
+	char magic[4];
+	if (!_input.is_open() || !_input.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+		spdlog::error("{} is not a recorded LCP file", file);
+		return false;
+	}
+	return true;
+}
+
+bool LCPReader::Next(LCPInstance &instance) {
+	int32_t frame_id, num_contact, num_tangent, friction_type, size;
+	if (!Read(_input, frame_id) || !Read(_input, num_contact) || !Read(_input, num_tangent)
+		|| !Read(_input, friction_type) || !Read(_input, size)) {
+		return false;
+	}
+	instance._frame_id = frame_id;
+	instance._num_contact = num_contact;
+	instance._num_tangent = num_tangent;
+	instance._friction_type = static_cast<LCPFrictionType>(friction_type);
+	instance._A.resize(size, size);
+	for (int i = 0; i < size; i++) {
+		for (int j = i; j < size; j++) {
+			if (!Read(_input, instance._A(i, j))) {
+				return false;
+			}
+			instance._A(j, i) = instance._A(i, j);
+		}
+	}
+	return ReadVector(_input, instance._b, size)
+		   && ReadVector(_input, instance._mu, num_contact)
+		   && ReadVector(_input, instance._x0, size);
+}
@@ -0,0 +1,67 @@
+#ifndef FEM_LCPRECORDER_H
+#define FEM_LCPRECORDER_H
+
+#include "Util/EigenAll.h"
+#include <fstream>
+#include <string>
+
+enum class LCPFrictionType {
+	kPolygon,	// nonnegative forces along the tangents, their sum bounded by mu times the normal force
+	kCone		// the friction cone ||t|| <= mu n
+};
+
+/**
+ * A contact problem with the matrix A and the constant term b of the contact
+ * velocities Ax + b, the friction coefficients and the warm start used in
+ * the simulation. Polygonal problems order the variables as [normal forces,
+ * friction forces], cone problems as (n, t1, t2) per contact.
+ */
+struct LCPInstance {
+	int _frame_id = 0;
+	int _num_contact = 0;
+	int _num_tangent = 0;
+	LCPFrictionType _friction_type = LCPFrictionType::kPolygon;
+	MatrixXd _A;		// symmetric
+	VectorXd _b;
+	VectorXd _mu;		// friction coefficients, one per contact
+	VectorXd _x0;		// warm start
+};
+
+/**
+ * Dump LCP instances into a binary file. Each record consists of
+ * 		int32 frame id, number of contacts, number of tangents, friction type, size n
+ * 		float64 upper triangle of A (row by row), b, mu, x0
+ */
+class LCPRecorder {
+public:
+	/**
+	 * @param file the file to write into, truncated if it exists
+	 * @return whether the file is successfully opened
+	 */
+	bool Open(const std::string &file);
+	bool IsOpen() const;
+	void Record(const LCPInstance &instance);
+	void Close();
+
+protected:
+	std::ofstream _output;
+};
+
+/**
+ * Read LCP instances dumped by LCPRecorder
+ */
+class LCPReader {
+public:
+	bool Open(const std::string &file);
+
+	/**
+	 * @param instance OUTPUT, the next instance in the file
+	 * @return false if no more instance is available
+	 */
+	bool Next(LCPInstance &instance);
+
+protected:
+	std::ifstream _input;
+};
+
+#endif //FEM_LCPRECORDER_H
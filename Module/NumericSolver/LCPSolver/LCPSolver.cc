@@ -6,4 +6,28 @@
 
 DEFINE_ACCESSIBLE_MEMBER(LCPSolverParameter, int, MaxStep, _max_step)
 DEFINE_ACCESSIBLE_MEMBER(LCPSolverParameter, double, MaxError, _max_error)
-DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(LCPSolverParameter, double, Lambda)
\ No newline at end of file
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(LCPSolverParameter, double, Lambda)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(LCPSolverParameter, bool, MixedPrecision)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(LCPSolverParameter, int, RefinementStep)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(LCPSolverParameter, int, SmallSize)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(LCPSolverParameter, int, LargeSize)
+DEFINE_VIRTUAL_ACCESSIBLE_MEMBER(LCPSolverParameter, int, ExplorePeriod)
+
+VectorXd LCPSolver::Solve(const MatrixXd &A, const VectorXd &b,
+						  const VectorXd &x0, int block_size) const {
+	VectorXd x;
+	if (x0.size() == b.size()) {
+		x = x0;
+	} else {
+		x.setZero(b.size());
+	}
+	Solve(DenseLCPOperator(A), b, x, block_size);
+	return x;
+}
+
+Eigen::Block<MatrixXd> LCPSolver::Reserve(MatrixXd &buffer, int rows, int cols) {
+	if (buffer.rows() < rows || buffer.cols() < cols) {
+		buffer.resize(std::max<int>(rows, buffer.rows()), std::max<int>(cols, buffer.cols()));
+	}
+	return buffer.topLeftCorner(rows, cols);
+}
@@ -7,6 +7,7 @@
 
 #include "Util/EigenAll.h"
 #include "Util/Pattern.h"
+#include "LCPOperator.h"
 
 class LCPSolverParameter {
 public:
@@ -20,13 +21,20 @@ public:
 	// Maximum error is the tolerance of the average of x_iy_i
 	DECLARE_ACCESSIBLE_MEMBER(double, MaxError, _max_error)
 	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(double, Lambda)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(bool, MixedPrecision)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(int, RefinementStep)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(int, SmallSize)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(int, LargeSize)
+	DECLARE_VIRTUAL_ACCESSIBLE_MEMBER(int, ExplorePeriod)
 };
 
 enum class LCPSolverType {
 	kPGS,
 	kBGS,
 	kPivot,
-	kOSQP
+	kOSQP,
+	kAdaptive,
+	kBoxQP
 };
 
 class LCPSolver {
@@ -35,12 +43,52 @@ public:
 		_max_step = para.GetMaxStep();
 		_max_error = para.GetMaxError();
 	}
-	virtual VectorXd Solve(const MatrixXd &A, const VectorXd& b, const VectorXd& x0 = VectorXd(), int block_size = 1) const = 0;
+
+	/**
+	 * Solve the LCP x >= 0, Ax + b >= 0, x^T(Ax + b) = 0
+	 * @param A INPUT, the linear operator of the LCP
+	 * @param b INPUT, the constant term
+	 * @param x INPUT & OUTPUT, the warm start on input and the solution on output
+	 * @param block_size size of the blocks for blocked solvers
+	 * @note Temporaries live in the workspace of the solver, which only grows.
+	 * 		 Once it reaches the high-water mark, solving does not allocate.
+	 */
+	virtual void Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+					   Eigen::Ref<VectorXd> x, int block_size = 1) const = 0;
+
+	//-> Convenient interface for dense A, x0 is ignored if its size mismatches
+	VectorXd Solve(const MatrixXd &A, const VectorXd& b, const VectorXd& x0 = VectorXd(), int block_size = 1) const;
+
+	//-> Number of iterations spent in the last solve, -1 if unknown
+	int GetNumIterations() const {
+		return _num_iterations;
+	}
+
+	//-> Whether the last solve reached the tolerance
+	bool IsConverged() const {
+		return _converged;
+	}
+
 	virtual ~LCPSolver() = default;
 
 protected:
+	//-> The first size entries of buffer, buffer grows if it is too small
+	template<class Scalar>
+	static Eigen::VectorBlock<VectorX<Scalar>> Reserve(VectorX<Scalar> &buffer, int size) {
+		if (buffer.size() < size) {
+			buffer.resize(size);
+		}
+		return buffer.head(size);
+	}
+
+	//-> The top left (rows x cols) block of buffer, buffer grows if it is too small
+	static Eigen::Block<MatrixXd> Reserve(MatrixXd &buffer, int rows, int cols);
+
 	int _max_step;
 	double _max_error;
+
+	mutable int _num_iterations = -1;
+	mutable bool _converged = true;
 };
 
 #endif //FEM_LCPSOLVER_H
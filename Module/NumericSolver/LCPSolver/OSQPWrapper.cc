@@ -5,50 +5,81 @@
 #include "OSQPWrapper.h"
 #include <OsqpEigen/OsqpEigen.h>
 #include <spdlog/spdlog.h>
+#include "Util/Telemetry.h"
 
 DEFINE_CLONE(LCPSolverParameter, OSQPWrapperParameter)
 
-VectorXd
-OSQPWrapper::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
-				   int block_size) const {
+OSQPWrapper::OSQPWrapper() = default;
+
+OSQPWrapper::~OSQPWrapper() = default;
+
+void OSQPWrapper::ToFullPattern(const Eigen::Ref<const MatrixXd> &dense, SparseMatrixXd &sparse) {
+	const int rows = dense.rows(), cols = dense.cols();
+	if (sparse.rows() != rows || sparse.cols() != cols || sparse.nonZeros() != rows * cols) {
+		sparse.resize(rows, cols);
+		sparse.reserve(Eigen::VectorXi::Constant(cols, rows));
+		for (int j = 0; j < cols; j++) {
+			for (int i = 0; i < rows; i++) {
+				sparse.insert(i, j) = 0;
+			}
+		}
+		sparse.makeCompressed();
+	}
+	// with a full pattern, the values are exactly the column major dense matrix
+	Eigen::Map<MatrixXd>(sparse.valuePtr(), rows, cols) = dense;
+}
+
+void OSQPWrapper::Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+						Eigen::Ref<VectorXd> x, int block_size) const {
 	const int size = b.size();
 	if (size == 0) {
-		return VectorXd(0);
+		_converged = true;
+		return;
 	}
-	SparseMatrixXd A_sparse = A.sparseView();
-	VectorXd b_tmp = b;
+	TelemetryScope telemetry("OSQP");
+	auto A_dense = Reserve(_A, size, size);
+	A.ToDense(A_dense);
+	ToFullPattern(A_dense, _hessian);
 
-	SparseMatrixXd constraints(size, size);
-	std::vector<Tripletd> COO;
-	for (int i = 0; i < size; i++) {
-		COO.push_back(Tripletd(i, i, 1));
-	}
-	constraints.setFromTriplets(COO.begin(), COO.end());
+	if (_size != size) {
+		// the dimensions of OSQP are fixed at setup
+		_size = size;
+		_b = b;
+		_constraints.resize(size, size);
+		_constraints.setIdentity();
+		_lower_bound.setZero(size);
+		_upper_bound.setConstant(size, OsqpEigen::INFTY);
 
-	VectorXd lower_bound(size), upper_bound(size);
-	for (int i = 0; i < size; i++) {
-		lower_bound(i) = 0;
-		upper_bound(i) = OsqpEigen::INFTY;
+		_solver = std::make_unique<OsqpEigen::Solver>();
+		_solver->settings()->setWarmStart(true);
+		_solver->data()->setNumberOfVariables(size);
+		_solver->data()->setNumberOfConstraints(size);
+		_solver->data()->setHessianMatrix(_hessian);
+		_solver->data()->setGradient(_b);
+		_solver->data()->setLinearConstraintsMatrix(_constraints);
+		_solver->data()->setLowerBound(_lower_bound);
+		_solver->data()->setUpperBound(_upper_bound);
+		_solver->initSolver();
+	} else {
+		// same pattern, OSQP updates the values in place
+		_solver->updateHessianMatrix(_hessian);
+		_solver->updateGradient(b);
 	}
+	// warm start from the guess of the caller rather than the last solution
+	_solver->setPrimalVariable(x);
 
-	OsqpEigen::Solver solver;
-	solver.settings()->setWarmStart(true);
-	solver.data()->setNumberOfVariables(size);
-//	spdlog::info("Successfully set solver n = {}", size);
-	solver.data()->setNumberOfConstraints(size);
-//	spdlog::info("Successfully set solver m = {}", size);
-	solver.data()->setHessianMatrix(A_sparse);
-//	spdlog::info("Successfully set solver hessian");
-	solver.data()->setGradient(b_tmp);
-//	spdlog::info("Successfully set solver gradient");
-	solver.data()->setLinearConstraintsMatrix(constraints);
-	solver.data()->setLowerBound(lower_bound);
-	solver.data()->setUpperBound(upper_bound);
-//	spdlog::info("Successfully set solver constraints");
-
-	solver.initSolver();
-//	auto t = clock();
-	solver.solveProblem();
-//	spdlog::info("Time spent on solving LCP: {}s", (clock() - t) / CLOCKS_PER_SEC);
-	return solver.getSolution();
-}
\ No newline at end of file
+	// solveProblem only reports errors of the call, whether OSQP reaches the tolerance is in its status
+	const bool solved = _solver->solveProblem() == OsqpEigen::ErrorExitFlag::NoError;
+	_converged = solved && _solver->getStatus() == OsqpEigen::Status::Solved;
+	_num_iterations = solved ? static_cast<int>(_solver->workspace()->info->iter) : -1;
+	if (!solved) {
+		spdlog::warn("OSQP, fail to solve the problem");
+	} else if (!_converged) {
+		spdlog::warn("OSQP, fail to converge, status: {}", _solver->workspace()->info->status_val);
+	}
+	if (solved) {
+		// on failure the solution is meaningless, leave the guess as it is
+		x = _solver->getSolution();
+	}
+	telemetry.Finish(_num_iterations, _converged);
+}
@@ -6,6 +6,11 @@
 #define TEST_OSQPWRAPPER_H
 
 #include "LCPSolver.h"
+#include <memory>
+
+namespace OsqpEigen {
+	class Solver;
+}
 
 class OSQPWrapperParameter : public LCPSolverParameter {
 public:
@@ -16,7 +21,28 @@ public:
 
 class OSQPWrapper : public LCPSolver {
 public:
-	VectorXd Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0 = VectorXd(), int block_size = 1) const override;
+	OSQPWrapper();
+	~OSQPWrapper() override;
+
+	using LCPSolver::Solve;
+	void Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+			   Eigen::Ref<VectorXd> x, int block_size = 1) const override;
+
+	/**
+	 * Copy dense into sparse, which keeps a full pattern. The pattern is only
+	 * rebuilt when the size changes, so OSQP can update the values in place.
+	 */
+	static void ToFullPattern(const Eigen::Ref<const MatrixXd> &dense, SparseMatrixXd &sparse);
+
+protected:
+	// Workspace, OSQP is only set up again when the size of the problem changes
+	mutable std::unique_ptr<OsqpEigen::Solver> _solver;
+	mutable int _size = -1;
+	mutable MatrixXd _A;
+	mutable SparseMatrixXd _hessian;
+	mutable VectorXd _b;
+	mutable SparseMatrixXd _constraints;
+	mutable VectorXd _lower_bound, _upper_bound;
 };
 
 #endif //TEST_OSQPWRAPPER_H
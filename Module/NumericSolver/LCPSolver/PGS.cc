@@ -6,62 +6,106 @@
 #include <iostream>
 #include <spdlog/spdlog.h>
 #include <limits>
+#include "Util/Telemetry.h"
 
 DEFINE_CLONE(LCPSolverParameter, PGSParameter)
 DEFINE_ACCESSIBLE_MEMBER(PGSParameter, double, Lambda, _lambda)
+DEFINE_ACCESSIBLE_MEMBER(PGSParameter, bool, MixedPrecision, _mixed_precision)
+DEFINE_ACCESSIBLE_MEMBER(PGSParameter, int, RefinementStep, _refinement_step)
 
-VectorXd PGS::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
-					int block_size) const {
+void PGS::Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+				Eigen::Ref<VectorXd> x, int block_size) const {
 //	std::cerr << "A: \n" << A << std::endl << "b: \n" << b.transpose() << std::endl;
 	const int size = b.size();
+	auto y = Reserve(_y, size);
+	TelemetryScope telemetry("PGS");
 
-	VectorXd x = x0;
+	int step;
+	bool converged;
+	if (_mixed_precision) {
+		const auto& A_single = A.Round(_rounding);
+		auto b_single = Reserve(_b_single, size);
+		auto x_single = Reserve(_x_single, size);
+		auto y_single = Reserve(_y_single, size);
+		b_single = b.cast<float>();
+		x_single = x.cast<float>();
 
-	const double dbl_max = std::numeric_limits<double>::max();
+		// single precision sweeps stall at the round-off of Ax + b, the refinement takes it from there
+		const float b_norm = size > 0 ? b_single.cwiseAbs().maxCoeff() : 0.0f;
+		const float tolerance = std::max<float>(_max_error, 1e2f * std::numeric_limits<float>::epsilon() * b_norm);
+		const int single_step = Sweep<float>(A_single, b_single, x_single, y_single, _max_step, tolerance, "PGS-single");
+
+		if (single_step < 0) {
+			step = -1;
+		} else {
+			x = x_single.cast<double>();
+			step = Sweep<double>(A, b, x, y, _refinement_step, _max_error, "PGS");
+		}
+		converged = step >= 0 && step <= _refinement_step;
+		_num_iterations = std::min(std::max(single_step, 0), _max_step) + std::min(std::max(step, 0), _refinement_step);
+	} else {
+		step = Sweep<double>(A, b, x, y, _max_step, _max_error, "PGS");
+		converged = step >= 0 && step <= _max_step;
+		_num_iterations = std::min(std::max(step, 0), _max_step);
+	}
+
+//	std::cerr << "x: \n" << x.transpose() << std::endl;
+//	std::cerr << "y: \n" << (A * x + b).transpose() << std::endl;
+
+	_converged = converged;
+	telemetry.Finish(_num_iterations, converged);
+	if (converged) {
+		spdlog::info("PGS method, converge in {} steps", _num_iterations);
+	} else {
+		spdlog::warn("PGS method, fail to converge, steps: {}", _num_iterations);
+	}
+}
+
+template<class Scalar>
+int PGS::Sweep(const BasicLCPOperator<Scalar> &A, const Eigen::Ref<const VectorX<Scalar>> &b,
+			   Eigen::Ref<VectorX<Scalar>> x, Eigen::Ref<VectorX<Scalar>> y,
+			   int max_step, Scalar tolerance, const char* source) const {
+	const int size = b.size();
+	const Scalar max_scalar = std::numeric_limits<Scalar>::max();
+	const Scalar lambda = _lambda;
+	const Scalar zero_diagonal = _max_error;
 
 	int step = 0;
-	while (step++ < _max_step) {
-		double change = 0;
-		double inf_norm = 0;
+	while (step++ < max_step) {
+		Scalar change = 0;
+		Scalar inf_norm = 0;
 		for (int i = 0; i < size; i++) {
-			double ri = A.row(i).dot(x) + b(i);
-			if (A(i, i) < _max_error && A(i, i) > -_max_error) {
+			Scalar ri = A.RowDot(i, x) + b(i);
+			const Scalar Aii = A.Diagonal(i);
+			if (Aii < zero_diagonal && Aii > -zero_diagonal) {
 				spdlog::error("Zero diagonal number at ({}, {})!", i, i);
-				exit(0);
+				return -1;
 			}
-			double x_pre = x(i);
-			x(i) = std::max(0.0, x(i) - _lambda * ri / A(i, i));
+			Scalar x_pre = x(i);
+			x(i) = std::max<Scalar>(0, x(i) - lambda * ri / Aii);
 			change = std::max(std::abs(x_pre - x(i)), change);
 			if (x(i) > inf_norm) {
 				inf_norm = x(i);
 			}
  		}
-		VectorXd y = A * x + b;
-		double min_y = 0, max_violate = 0;
+		A.Apply(x, y);
+		y += b;
+		Scalar min_y = 0, max_violate = 0;
 		for (int i = 0; i < size; i++) {
 			min_y = std::min(min_y, y(i));
-			if (min_y < -_max_error * inf_norm) {
-				max_violate = dbl_max;
+			if (min_y < -tolerance * inf_norm) {
+				max_violate = max_scalar;
 			} else {
 				max_violate = std::max(max_violate, std::min(x(i), y(i)));
 			}
 		}
-		if (max_violate < _max_error) {
+		TELEMETRY(Iteration(source, step, max_violate == max_scalar ? -min_y : max_violate));
+		if (max_violate < tolerance) {
 			break;
 		}
-		if (change < _max_error) {
+		if (change < tolerance) {
 			break;
 		}
 	}
-
-//	std::cerr << "x: \n" << x.transpose() << std::endl;
-//	std::cerr << "y: \n" << (A * x + b).transpose() << std::endl;
-
-	if (step < _max_step + 1) {
-		spdlog::info("PGS method, converge in {} steps", step);
-	} else {
-		spdlog::warn("PGS method, fail to converge, steps: {}", step);
-	}
-
-	return x;
+	return step;
 }
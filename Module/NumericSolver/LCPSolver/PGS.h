@@ -9,10 +9,16 @@
 
 class PGSParameter : public LCPSolverParameter {
 public:
-	PGSParameter(int max_step, double max_error,  double lambda) : LCPSolverParameter(max_step, max_error), _lambda(lambda){}
+	PGSParameter(int max_step, double max_error,  double lambda, bool mixed_precision = false, int refinement_step = 10)
+		: LCPSolverParameter(max_step, max_error), _lambda(lambda),
+		  _mixed_precision(mixed_precision), _refinement_step(refinement_step) {}
 
 	DERIVED_DECLARE_CLONE(LCPSolverParameter)
 	DECLARE_ACCESSIBLE_MEMBER(double, Lambda, _lambda)
+
+	// Sweep in single precision, then refine with at most RefinementStep double precision sweeps
+	DECLARE_ACCESSIBLE_MEMBER(bool, MixedPrecision, _mixed_precision)
+	DECLARE_ACCESSIBLE_MEMBER(int, RefinementStep, _refinement_step)
 };
 
 class PGS : public LCPSolver {
@@ -20,11 +26,29 @@ public:
 	void Initialize(const LCPSolverParameter &para) override {
 		LCPSolver::Initialize(para);
 		_lambda = para.GetLambda();
+		_mixed_precision = para.GetMixedPrecision();
+		_refinement_step = para.GetRefinementStep();
 	}
-	VectorXd Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0 = VectorXd(), int block_size = 1) const override;
+	using LCPSolver::Solve;
+	void Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+			   Eigen::Ref<VectorXd> x, int block_size = 1) const override;
 
 protected:
+	//-> at most max_step projected sweeps, returns max_step + 1 if not converged and -1 on a zero diagonal
+	template<class Scalar>
+	int Sweep(const BasicLCPOperator<Scalar> &A, const Eigen::Ref<const VectorX<Scalar>> &b,
+			  Eigen::Ref<VectorX<Scalar>> x, Eigen::Ref<VectorX<Scalar>> y,
+			  int max_step, Scalar tolerance, const char* source) const;
+
 	double _lambda;
+	bool _mixed_precision;
+	int _refinement_step;
+
+	mutable VectorXd _y;	// workspace for Ax + b
+
+	// workspaces of the single precision sweeps
+	mutable LCPRoundingBuffer _rounding;
+	mutable VectorXf _b_single, _x_single, _y_single;
 };
 
 #endif //FEM_PGS_H
@@ -6,45 +6,92 @@
 #include <vector>
 #include <spdlog/spdlog.h>
 #include <limits>
-#include <set>
 #include <iostream>
+#include "Util/Telemetry.h"
 
 DEFINE_CLONE(LCPSolverParameter, PivotingMethodParameter)
 
-VectorXd
-PivotingMethod::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
-					  int block_size) const {
+namespace {
+	enum SetStatus : char {
+		kUnused,
+		kActive,	// in A set
+		kFree		// in F set
+	};
+
+	/**
+	 * Solve Mz = r with Gaussian elimination (partial pivoting), without allocation
+	 * @param M INPUT, destroyed afterwards
+	 * @param r INPUT & OUTPUT, overwritten by z
+	 * @note components corresponding to vanishing pivots are set to zero
+	 */
+	void SolveInPlace(Eigen::Ref<MatrixXd> M, Eigen::Ref<VectorXd> r) {
+		const int n = M.rows();
+		const double eps = 1e-14;
+		for (int k = 0; k < n; k++) {
+			Eigen::Index p;
+			M.col(k).tail(n - k).cwiseAbs().maxCoeff(&p);
+			p += k;
+			if (p != k) {
+				M.row(k).swap(M.row(p));
+				std::swap(r(k), r(p));
+			}
+			const double pivot = M(k, k);
+			if (std::abs(pivot) < eps) {
+				continue;
+			}
+			for (int i = k + 1; i < n; i++) {
+				const double factor = M(i, k) / pivot;
+				M.row(i).tail(n - k) -= factor * M.row(k).tail(n - k);
+				r(i) -= factor * r(k);
+			}
+		}
+		for (int k = n - 1; k >= 0; k--) {
+			if (std::abs(M(k, k)) < eps) {
+				r(k) = 0;
+			} else {
+				r(k) = (r(k) - M.row(k).tail(n - k - 1).dot(r.tail(n - k - 1))) / M(k, k);
+			}
+		}
+	}
+}
+
+void
+PivotingMethod::Solve(const LCPOperator &A_op, const Eigen::Ref<const VectorXd> &b,
+					  Eigen::Ref<VectorXd> x, int block_size) const {
 //	std::cerr << "A:\n" << A << std::endl << "b: " << b.transpose() << std::endl;
 
-	VectorXd x;
-	x.resizeLike(b);
-	x.setZero();
 	const int size = b.size();
 	const double dbl_max = std::numeric_limits<double>::max();
 
-	std::vector<int> A_set, F_set;
-	std::set<int> unused_set;
-	std::set<int> unfeasible_set;	// unfeasible set in selecting the proper y to pivot
+	auto A = Reserve(_A, size, size);
+	A_op.ToDense(A);
+	auto y = Reserve(_y, size);
+	x.setZero();
+	TelemetryScope telemetry("Pivot");
 
-	for (int i = 0; i < size; i++) {
-		unused_set.insert(i);
-	}
+	auto& A_set = _A_set;
+	auto& F_set = _F_set;
+	A_set.clear();
+	F_set.clear();
+	A_set.reserve(size);
+	F_set.reserve(size);
+	_status.assign(size, kUnused);
+	_unfeasible.assign(size, false);
+	int num_unfeasible = 0;
 
 	int step = 0;
 	int ready_count = 0;	// how many indices are currently in A union F
 	while (step++ < _max_step) {
-		VectorXd y = A * x + b;
+		y.noalias() = A * x;
+		y += b;
 
-		int F_old_size = F_set.size();
-		for (auto &itr : unused_set) {
-			if (y(itr) > 0) {
-//				spdlog::info("Moving {} into F set", itr);
-				F_set.push_back(itr);
+		for (int i = 0; i < size; i++) {
+			if (_status[i] == kUnused && y(i) > 0) {
+//				spdlog::info("Moving {} into F set", i);
+				F_set.push_back(i);
+				_status[i] = kFree;
 			}
 		}
-		for (int i = F_old_size, F_size = F_set.size(); i < F_size; i++) {
-			unused_set.erase(F_set[i]);
-		}
 
 //		spdlog::info("Round {} begins, starting info: ", step);
 //		std::cerr << "x: " << x.transpose() << std::endl
@@ -58,29 +105,42 @@ PivotingMethod::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
 
 		int j = -1;				// the index of y to make positive
 		double min_y = 0;		// minimum of y
-		for (auto &itr : unused_set) {
-			if (y(itr) < min_y && unfeasible_set.find(itr) == unfeasible_set.end()) {
-				j = itr;
-				min_y = y(itr);
+		for (int i = 0; i < size; i++) {
+			if (_status[i] == kUnused && y(i) < min_y && !_unfeasible[i]) {
+				j = i;
+				min_y = y(i);
 			}
 		}
+		TELEMETRY(Iteration("Pivot", step, -min_y));
 		if (j == -1) {
 			// all positive or all negative y are unfeasible to make positive
 			break;
 		}
 
-		VectorXd delta_x_A(A_set.size());
+		const int A_size = A_set.size(), F_size = F_set.size();
+		auto delta_x_A = Reserve(_delta_x_A, A_size);
 		if (!A_set.empty()) {
-			delta_x_A = -A(A_set, A_set).colPivHouseholderQr().solve(
-					A(A_set, j));
+			auto A_AA = Reserve(_A_AA, A_size, A_size);
+			A_AA = A(A_set, A_set);
+			delta_x_A = -A(A_set, j);
+			SolveInPlace(A_AA, delta_x_A);
 		}
 
-		VectorXd delta_y_F = A(F_set, j) + A(F_set, A_set) * delta_x_A;
-		double delta_y_j = A(j, j) + A(j, A_set) * delta_x_A;
+		auto delta_y_F = Reserve(_delta_y_F, F_size);
+		for (int i = 0; i < F_size; i++) {
+			delta_y_F(i) = A(F_set[i], j);
+			for (int k = 0; k < A_size; k++) {
+				delta_y_F(i) += A(F_set[i], A_set[k]) * delta_x_A(k);
+			}
+		}
+		double delta_y_j = A(j, j);
+		for (int k = 0; k < A_size; k++) {
+			delta_y_j += A(j, A_set[k]) * delta_x_A(k);
+		}
 
 		int bound_A_index = -1, bound_F_index = -1;
 		double bound_A = dbl_max, bound_F = dbl_max, bound_j = dbl_max;
-		for (int i = 0, A_size = A_set.size(); i < A_size; i++) {
+		for (int i = 0; i < A_size; i++) {
 			if (delta_x_A(i) < 0) {
 				if (bound_A_index == -1 || - x(A_set[i]) / delta_x_A(i) < bound_A) {
 					bound_A_index = i;
@@ -88,7 +148,7 @@ PivotingMethod::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
 				}
 			}
 		}
-		for (int i = 0, F_size = F_set.size(); i < F_size; i++) {
+		for (int i = 0; i < F_size; i++) {
 			if (delta_y_F(i) < 0) {
 				if (bound_F_index == -1 || - y(F_set[i]) / delta_y_F(i) < bound_F) {
 					bound_F_index = i;
@@ -100,13 +160,17 @@ PivotingMethod::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
 			bound_j = - y(j) / delta_y_j;
 		}
 		if (bound_A_index == -1 && bound_F_index == -1 && delta_y_j < 1e-10) {
-			unfeasible_set.insert(j);
+			_unfeasible[j] = true;
+			num_unfeasible++;
 //			spdlog::info("Round {} finished, Add {} into unfeasible set", step, j);
-			if (unfeasible_set.size() > size) {
+			if (num_unfeasible > size) {
 				break;
 			}
 		} else {
-			unfeasible_set.clear();
+			if (num_unfeasible > 0) {
+				std::fill(_unfeasible.begin(), _unfeasible.end(), false);
+				num_unfeasible = 0;
+			}
 			double bound = std::min(bound_A, std::min(bound_F, bound_j));
 //			spdlog::info("Round {} finishes", step);
 //			spdlog::info("Bound for this round: {}", bound);
@@ -122,16 +186,18 @@ PivotingMethod::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
 				int alter_id = A_set[bound_A_index];
 				A_set.erase(A_set.begin() + bound_A_index);
 				F_set.push_back(alter_id);
+				_status[alter_id] = kFree;
 //				std::cerr << "Moving " << alter_id << " from A to F" << std::endl;
 			} else if (bound == bound_F) {
 				int alter_id = F_set[bound_F_index];
 				A_set.push_back(alter_id);
 				F_set.erase(F_set.begin() + bound_F_index);
+				_status[alter_id] = kActive;
 //				std::cerr << "Moving " << alter_id << " from F to A" << std::endl;
 			} else {
 //				std::cerr << "Adding " << j << " into A" << std::endl;
 				A_set.push_back(j);
-				unused_set.erase(j);
+				_status[j] = kActive;
 				ready_count++;
 			}
 		}
@@ -140,8 +206,11 @@ PivotingMethod::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
 		}
 	}
 
+	_num_iterations = std::min(step, _max_step);
+	_converged = step < _max_step + 1 && num_unfeasible == 0;
+	telemetry.Finish(_num_iterations, _converged);
 	if (step < _max_step + 1) {
-		if (unfeasible_set.empty()) {
+		if (num_unfeasible == 0) {
 			spdlog::info("Pivoting Method, converges in {} steps", step);
 		} else {
 			spdlog::error("Pivoting Method, run into unfeasible situation");
@@ -149,5 +218,4 @@ PivotingMethod::Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0,
 	} else {
 		spdlog::warn("Pivoting Method, fail to converge");
 	}
-	return x;
 }
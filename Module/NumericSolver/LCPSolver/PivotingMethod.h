@@ -6,6 +6,7 @@
 #define FEM_PIVOT_H
 
 #include "LCPSolver.h"
+#include <vector>
 
 class PivotingMethodParameter : public LCPSolverParameter {
 public:
@@ -16,7 +17,18 @@ public:
 
 class PivotingMethod : public LCPSolver {
 public:
-	VectorXd Solve(const MatrixXd &A, const VectorXd &b, const VectorXd &x0 = VectorXd(), int block_size = 1) const override;
+	using LCPSolver::Solve;
+	void Solve(const LCPOperator &A, const Eigen::Ref<const VectorXd> &b,
+			   Eigen::Ref<VectorXd> x, int block_size = 1) const override;
+
+protected:
+	// Workspace
+	mutable MatrixXd _A;					// dense copy of A
+	mutable MatrixXd _A_AA;					// A(A_set, A_set), destroyed while solving
+	mutable VectorXd _y, _delta_x_A, _delta_y_F;
+	mutable std::vector<int> _A_set, _F_set;
+	mutable std::vector<char> _status;		// which set each index lies in
+	mutable std::vector<char> _unfeasible;	// unfeasible in selecting the proper y to pivot
 };
 
 #endif //FEM_PIVOT_H
@@ -5,6 +5,7 @@
 #include "NewtonIterator.h"
 #include "Util/EigenAll.h"
 #include <spdlog/spdlog.h>
+#include "Util/Telemetry.h"
 
 using Eigen::ConjugateGradient;
 
@@ -32,15 +33,18 @@ VectorXd NewtonIterator::Optimize(const VectorXd &x0) const {
 
 	int step = 0;
 	ConjugateGradient<SparseMatrixXd> solver;
+	TelemetryScope telemetry("Newton");
 	while (step++ < _max_step) {
 //		spdlog::info("Newton Iterator, round {}", step);
 		SparseMatrixXd hessian = _target->Hessian(x);
 
 		double alpha = 0.002;
+		int num_retry = 0;
 		solver.compute(hessian);
 		while (solver.info() != Eigen::Success) {
 			alpha *= 2;
 			hessian.diagonal() += alpha * I;
+			TELEMETRY(Regularization("Newton", ++num_retry, alpha));
 			solver.compute(hessian);
 		}
 		spdlog::info("Change into SPD matrix, alpha = {}", alpha);
@@ -60,11 +64,13 @@ VectorXd NewtonIterator::Optimize(const VectorXd &x0) const {
 
 		x += t * p;
 
+		TELEMETRY(Iteration("Newton", step, gradient.norm()));
 		if (gradient.norm() < _max_error) {
 			break;
 		}
 		spdlog::info("Error: {}, continue iterating", gradient.norm());
 	}
+	telemetry.Finish(std::min<int>(step, _max_step), step <= _max_step);
 	if (step <= _max_step) {
 		spdlog::info("Newton Method converges in {} steps", step);
 	} else {
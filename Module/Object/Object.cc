@@ -3,6 +3,10 @@
 //
 
 #include "Object.h"
+#include <limits>
+
+DEFINE_ACCESSIBLE_MEMBER(Object, unsigned, CollisionGroup, _collision_group)
+DEFINE_ACCESSIBLE_MEMBER(Object, unsigned, CollisionMask, _collision_mask)
 
 double Object::Energy() const {
 	return InternalEnergy() + ExternalEnergy();
@@ -40,13 +44,50 @@ Object::ExternalEnergyHessianCOO(COO &coo, int x_offset, int y_offset) const {
 	}
 }
 
+void Object::AppendJ(int idx, const Vector3d &barycentric, const Vector3d &point, const Vector3d &direction,
+					 double weight, int row, int col_offset, COO &coo) const {
+	const SparseMatrixXd J = GetJ(idx, barycentric, point);
+	for (int k = 0; k < J.outerSize(); k++) {
+		for (SparseMatrixXd::InnerIterator it(J, k); it; ++it) {
+			coo.push_back(Tripletd(row, it.col() + col_offset, weight * direction(it.row()) * it.value()));
+		}
+	}
+}
+
+void Object::BuildBVH() {
+	_bvh.Build(GetSurfacePosition(), GetSurfaceTopo());
+}
+
+void Object::UpdateBVH() {
+	const RowMatrixX3dRef surface_position = GetSurfacePosition();
+	_bvh.Refit(surface_position);
+	if (_bvh.IsDegraded()) {
+		_bvh.Build(surface_position, GetSurfaceTopo());
+	}
+}
+
+void Object::GetBVHFrame(Matrix3d &rotation, Vector3d &translation) const {
+	rotation.setIdentity();
+	translation.setZero();
+}
+
+double Object::SignedDistance(const Vector3d &/*point*/, Vector3d &gradient) const {
+	gradient.setZero();
+	return std::numeric_limits<double>::infinity();
+}
+
 Object::~Object() noexcept {
 	for (auto& ext_force : _external_force) {
 		delete ext_force;
 	}
 }
 
-Object::Object(const Object &obj) {
+bool Object::CanCollide(const Object &rhs) const {
+	return (_collision_group & rhs._collision_mask) && (rhs._collision_group & _collision_mask);
+}
+
+Object::Object(const Object &obj)
+	: _collision_group(obj._collision_group), _collision_mask(obj._collision_mask), _bvh(obj._bvh) {
 	for (auto& ext_force : obj._external_force) {
 		_external_force.push_back(ext_force->Clone());
 	}
@@ -63,6 +104,9 @@ Object &Object::operator=(const Object &rhs) {
 	for (auto& ext_force : rhs._external_force) {
 		_external_force.push_back(ext_force);
 	}
+	_bvh = rhs._bvh;
+	_collision_group = rhs._collision_group;
+	_collision_mask = rhs._collision_mask;
 	return *this;
 }
 
@@ -8,6 +8,7 @@
 #include "Util/EigenAll.h"
 #include "Util/Pattern.h"
 #include "BodyEnergy/ExternalForce.h"
+#include "Contact/BVH/BVH.h"
 #include <vector>
 
 enum class OutputFormatType {
@@ -15,9 +16,17 @@ enum class OutputFormatType {
 	kObj
 };
 
+// Two objects collide only if the group of each one is in the mask of the other
+enum CollisionGroup : unsigned {
+	kDefaultGroup = 1u << 0,
+	kRobotArmGroup = 1u << 1,
+	kSlabGroup = 1u << 2,
+	kAllGroups = ~0u
+};
+
 class Object {
 public:
-	Object() = default;
+	Object() : _collision_group(kDefaultGroup), _collision_mask(kAllGroups) {}
 
 	//-> degree of freedom of the objects
 	virtual int GetDOF() const = 0;
@@ -53,12 +62,67 @@ public:
 	//-> HessianCOO of external energy
 	void ExternalEnergyHessianCOO(COO &coo, int x_offset, int y_offset) const;
 
-	// From DOF to shape
-	virtual Matrix<int, Dynamic, 3> GetSurfaceTopo() const = 0;
-	virtual MatrixXd GetSurfacePosition() const = 0;
-
-	// From shape to DOF
-	virtual SparseMatrixXd GetJ(int idx, const Vector3d &point) const = 0;
+	// From DOF to shape, the surface is returned as views of buffers kept by
+	// the object, as computed by the last UpdateSurface
+	virtual const Matrix<int, Dynamic, 3>& GetSurfaceTopo() const = 0;
+	virtual RowMatrixX3dRef GetSurfacePosition() const = 0;
+
+	//-> velocities of the vertices of GetSurfacePosition, one in a row
+	virtual RowMatrixX3dRef GetSurfaceVelocity() const = 0;
+
+	//-> bring the buffers behind the surface views up to date with the status,
+	// call it after changing the status, the views never refresh themselves
+	virtual void UpdateSurface() {}
+
+	//-> BVH of the surface, in the frame given by GetBVHFrame
+	const BVH& GetBVH() const {
+		return _bvh;
+	}
+
+	//-> build the BVH of the surface from scratch, call it when the surface topology changes
+	virtual void BuildBVH();
+
+	//-> bring the BVH up to date with the current status
+	virtual void UpdateBVH();
+
+	//-> the frame of the BVH, a point x in it is at rotation * x + translation in the world
+	virtual void GetBVHFrame(Matrix3d &rotation, Vector3d &translation) const;
+
+	//-> whether the surface can fold onto itself
+	virtual bool IsDeformable() const {
+		return false;
+	}
+
+	//-> whether SignedDistance is known in closed form
+	virtual bool HasSignedDistance() const {
+		return false;
+	}
+
+	/**
+	 * Signed distance of a point to the object, negative inside, infinite
+	 * for objects without one
+	 * @param point INPUT, the point in the world
+	 * @param gradient OUTPUT, the gradient of the distance in the world
+	 */
+	virtual double SignedDistance(const Vector3d &point, Vector3d &gradient) const;
+
+	/**
+	 * From shape to DOF, the Jacobian of a point on the surface
+	 * @param idx, barycentric INPUT, the face of the surface the point is on
+	 * 		  and its weights on the vertices of the face, for deformable objects
+	 * @param point INPUT, the point in the world, for rigid objects
+	 */
+	virtual SparseMatrixXd GetJ(int idx, const Vector3d &barycentric, const Vector3d &point) const = 0;
+
+	/**
+	 * Append weight * direction^T GetJ(idx, barycentric, point), the row of
+	 * the Jacobian along a direction, to a sparse matrix without forming GetJ
+	 * @param row INPUT, row of the entries
+	 * @param col_offset INPUT, column of the first DOF of the object
+	 * @param coo OUTPUT, the entries are appended to it
+	 */
+	virtual void AppendJ(int idx, const Vector3d &barycentric, const Vector3d &point, const Vector3d &direction,
+						 double weight, int row, int col_offset, COO &coo) const;
 
 	virtual void Store(const std::string &filename, const OutputFormatType &format) const = 0;
 
@@ -71,6 +135,13 @@ public:
 
 	Object& operator=(const Object& rhs);
 	BASE_DECLARE_CLONE(Object)
+
+	//-> whether the collision filter lets the two objects collide
+	bool CanCollide(const Object &rhs) const;
+
+	DECLARE_ACCESSIBLE_MEMBER(unsigned, CollisionGroup, _collision_group)
+	DECLARE_ACCESSIBLE_MEMBER(unsigned, CollisionMask, _collision_mask)
+
 protected:
 	// The internal energy of the object
 	virtual double InternalEnergy() const = 0;
@@ -81,6 +152,7 @@ protected:
 	VectorXd ExternalEnergyGradient() const;
 
 	std::vector<const ExternalForce*> _external_force;
+	BVH _bvh;
 };
 
 #endif //FEM_OBJECT_H
@@ -0,0 +1,163 @@
+#include "DistanceField.h"
+#include "Contact/CCD/CCD.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+
+namespace {
+	const int kBandCells = 2;			// half width of the exact band, wider than a cell diagonal
+	const int kPadCells = kBandCells + 1;	// nodes around the box of the surface
+}
+
+void DistanceField::Bake(const std::vector<Vector3d> &vertices, const Matrix<int, Dynamic, 3> &topo, double cell_size) {
+	_cell_size = cell_size;
+	Vector3d lower = Vector3d::Constant(std::numeric_limits<double>::max());
+	Vector3d upper = Vector3d::Constant(std::numeric_limits<double>::lowest());
+	for (const auto& vertex : vertices) {
+		lower = lower.cwiseMin(vertex);
+		upper = upper.cwiseMax(vertex);
+	}
+	_origin = lower - Vector3d::Constant(kPadCells * cell_size);
+	for (int i = 0; i < 3; i++) {
+		_dims(i) = static_cast<int>(std::ceil((upper(i) - lower(i)) / cell_size)) + 2 * kPadCells + 1;
+	}
+	const int num_nodes = _dims.prod();
+
+	// Angle weighted pseudo normals of the faces, edges and vertices
+	const int num_faces = topo.rows();
+	std::vector<Vector3d> face_normals(num_faces);
+	std::vector<Vector3d> vertex_normals(vertices.size(), Vector3d::Zero());
+	std::map<std::pair<int, int>, Vector3d> edge_normals;
+	for (int f = 0; f < num_faces; f++) {
+		const Vector3d &a = vertices[topo(f, 0)], &b = vertices[topo(f, 1)], &c = vertices[topo(f, 2)];
+		face_normals[f] = (b - a).cross(c - a).normalized();
+		for (int k = 0; k < 3; k++) {
+			const int v = topo(f, k), next = topo(f, (k + 1) % 3), prev = topo(f, (k + 2) % 3);
+			const double cos_angle = (vertices[next] - vertices[v]).normalized().dot((vertices[prev] - vertices[v]).normalized());
+			vertex_normals[v] += std::acos(std::max(-1.0, std::min(1.0, cos_angle))) * face_normals[f];
+			auto& edge_normal = edge_normals.emplace(std::minmax(v, next), Vector3d::Zero()).first->second;
+			edge_normal += face_normals[f];
+		}
+	}
+
+	// Exact distances in the band, signed by the pseudo normal of the nearest feature
+	const double band = kBandCells * cell_size;
+	std::vector<double> distances(num_nodes, std::numeric_limits<double>::infinity());
+	std::vector<double> signs(num_nodes, 1);
+	for (int f = 0; f < num_faces; f++) {
+		const Vector3d &a = vertices[topo(f, 0)], &b = vertices[topo(f, 1)], &c = vertices[topo(f, 2)];
+		const Vector3d face_lower = a.cwiseMin(b).cwiseMin(c) - Vector3d::Constant(band) - _origin;
+		const Vector3d face_upper = a.cwiseMax(b).cwiseMax(c) + Vector3d::Constant(band) - _origin;
+		Eigen::Vector3i begin, end;
+		for (int i = 0; i < 3; i++) {
+			begin(i) = std::max(0, static_cast<int>(std::ceil(face_lower(i) / cell_size)));
+			end(i) = std::min(_dims(i) - 1, static_cast<int>(std::floor(face_upper(i) / cell_size)));
+		}
+		for (int i = begin(0); i <= end(0); i++) {
+			for (int j = begin(1); j <= end(1); j++) {
+				for (int k = begin(2); k <= end(2); k++) {
+					const int node = Index(i, j, k);
+					const Vector3d point = _origin + cell_size * Vector3d(i, j, k);
+					Vector3d barycentric;
+					const double distance = PointTriangleDistance(point, a, b, c, barycentric);
+					if (distance > band || distance >= distances[node]) {
+						continue;
+					}
+					distances[node] = distance;
+
+					int features[3], num_features = 0;
+					for (int l = 0; l < 3; l++) {
+						if (barycentric(l) > 0) {
+							features[num_features++] = topo(f, l);
+						}
+					}
+					const Vector3d& normal = num_features == 3 ? face_normals[f]
+										   : num_features == 2 ? edge_normals[std::minmax(features[0], features[1])]
+										   : vertex_normals[features[0]];
+					const Vector3d closest = barycentric(0) * a + barycentric(1) * b + barycentric(2) * c;
+					signs[node] = (point - closest).dot(normal) < 0 ? -1 : 1;
+				}
+			}
+		}
+	}
+
+	// Shortest paths through the grid from the band to the nodes outside of
+	// it, the sign going along
+	typedef std::pair<double, int> Item;
+	std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+	std::vector<bool> is_exact(num_nodes);
+	for (int node = 0; node < num_nodes; node++) {
+		is_exact[node] = distances[node] < std::numeric_limits<double>::infinity();
+		if (is_exact[node]) {
+			queue.emplace(distances[node], node);
+		}
+	}
+	while (!queue.empty()) {
+		const auto [distance, node] = queue.top();
+		queue.pop();
+		if (distance > distances[node]) {
+			continue;
+		}
+		const int i = node / (_dims(1) * _dims(2)), j = node / _dims(2) % _dims(1), k = node % _dims(2);
+		for (int di = -1; di <= 1; di++) {
+			for (int dj = -1; dj <= 1; dj++) {
+				for (int dk = -1; dk <= 1; dk++) {
+					if (i + di < 0 || i + di >= _dims(0) || j + dj < 0 || j + dj >= _dims(1)
+						|| k + dk < 0 || k + dk >= _dims(2) || (di == 0 && dj == 0 && dk == 0)) {
+						continue;
+					}
+					const int neighbor = Index(i + di, j + dj, k + dk);
+					const double neighbor_distance = distance + cell_size * std::sqrt(di * di + dj * dj + dk * dk);
+					if (!is_exact[neighbor] && neighbor_distance < distances[neighbor]) {
+						distances[neighbor] = neighbor_distance;
+						signs[neighbor] = signs[node];
+						queue.emplace(neighbor_distance, neighbor);
+					}
+				}
+			}
+		}
+	}
+
+	_values.resize(num_nodes);
+	for (int node = 0; node < num_nodes; node++) {
+		_values[node] = signs[node] * distances[node];
+	}
+}
+
+double DistanceField::Query(const Vector3d &point, Vector3d &gradient) const {
+	const Vector3d upper = _origin + _cell_size * (_dims - Eigen::Vector3i::Ones()).cast<double>();
+	const Vector3d clamped = point.cwiseMax(_origin).cwiseMin(upper);
+	const Vector3d local = (clamped - _origin) / _cell_size;
+	Eigen::Vector3i cell;
+	Vector3d t;
+	for (int i = 0; i < 3; i++) {
+		cell(i) = std::min(static_cast<int>(local(i)), _dims(i) - 2);
+		t(i) = local(i) - cell(i);
+	}
+
+	// Trilinear interpolation and its derivative
+	double value = 0;
+	Vector3d derivative = Vector3d::Zero();
+	for (int corner = 0; corner < 8; corner++) {
+		const int di = corner >> 2 & 1, dj = corner >> 1 & 1, dk = corner & 1;
+		const double node_value = _values[Index(cell(0) + di, cell(1) + dj, cell(2) + dk)];
+		const double wx = di ? t(0) : 1 - t(0), wy = dj ? t(1) : 1 - t(1), wz = dk ? t(2) : 1 - t(2);
+		value += wx * wy * wz * node_value;
+		derivative(0) += (di ? 1 : -1) * wy * wz * node_value;
+		derivative(1) += (dj ? 1 : -1) * wx * wz * node_value;
+		derivative(2) += (dk ? 1 : -1) * wx * wy * node_value;
+	}
+
+	const Vector3d outside = point - clamped;
+	const double outside_distance = outside.norm();
+	if (outside_distance > 0) {
+		gradient = outside / outside_distance;
+		return value + outside_distance;
+	}
+	const double norm = derivative.norm();
+	gradient = norm > 0 ? Vector3d(derivative / norm) : Vector3d::Zero();
+	return value;
+}
@@ -0,0 +1,50 @@
+#ifndef FEM_DISTANCEFIELD_H
+#define FEM_DISTANCEFIELD_H
+
+#include "Util/EigenAll.h"
+#include <vector>
+
+/**
+ * Signed distance of a closed surface sampled on a regular grid, negative
+ * inside. The nodes within a narrow band of the surface hold the exact
+ * distance, signed by the angle weighted pseudo normal of the nearest
+ * feature, and the others the length of the shortest path through the grid
+ * to the band, so the field has a gradient everywhere.
+ * It is queried by trilinear interpolation.
+ */
+class DistanceField {
+public:
+	/**
+	 * Sample the field of a surface
+	 * @param vertices INPUT, vertices of the surface
+	 * @param topo INPUT, triangles of the surface, consistently oriented
+	 * 		  with the normals pointing outwards
+	 * @param cell_size INPUT, the spacing of the grid
+	 */
+	void Bake(const std::vector<Vector3d> &vertices, const Matrix<int, Dynamic, 3> &topo, double cell_size);
+
+	bool IsBaked() const {
+		return !_values.empty();
+	}
+
+	/**
+	 * @param point INPUT, the point in the frame of the surface
+	 * @param gradient OUTPUT, the normalized gradient of the interpolated
+	 * 		  field, outside the grid the direction from the grid to the point
+	 * @return the interpolated distance, plus the distance to the grid for
+	 * 		   points outside of it
+	 */
+	double Query(const Vector3d &point, Vector3d &gradient) const;
+
+protected:
+	int Index(int i, int j, int k) const {
+		return (i * _dims(1) + j) * _dims(2) + k;
+	}
+
+	Vector3d _origin;			// position of the node (0, 0, 0)
+	double _cell_size = 0;
+	Eigen::Vector3i _dims;		// number of nodes along each axis
+	std::vector<double> _values;
+};
+
+#endif //FEM_DISTANCEFIELD_H
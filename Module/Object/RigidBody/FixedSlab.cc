@@ -11,8 +11,16 @@ FixedSlab::FixedSlab(double mu, double rho, const Vector3d &center,
 	_mass = COO();
 	_x.resize(0);
 	_v.resize(0);
+	// slabs are static, neither other slabs nor robot arms are tested against them
+	_collision_group = kSlabGroup;
+	_collision_mask = ~(kSlabGroup | kRobotArmGroup);
 }
 
-SparseMatrixXd FixedSlab::GetJ(int idx, const Vector3d &point) const {
+SparseMatrixXd FixedSlab::GetJ(int idx, const Vector3d &barycentric, const Vector3d &point) const {
 	return SparseMatrixXd(3, 0);
+}
+
+void FixedSlab::AppendJ(int /*idx*/, const Vector3d &/*barycentric*/, const Vector3d &/*point*/, const Vector3d &/*direction*/,
+						double /*weight*/, int /*row*/, int /*col_offset*/, COO &/*coo*/) const {
+	// no DOF
 }
\ No newline at end of file
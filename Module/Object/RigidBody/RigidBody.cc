@@ -21,31 +21,82 @@ RigidBody::RigidBody(const RigidBody &rhs) : Object(rhs) {
 	_mu = rhs._mu;
 	_rho = rhs._rho;
 	_shape = rhs._shape->Clone();
+	_distance_field = rhs._distance_field;
 	_center = rhs._center;
 	_rotation = rhs._rotation;
 	_x = rhs._x;
 	_v = rhs._v;
 	_mass = rhs._mass;
+	_surface_position = rhs._surface_position;
+	_surface_velocity = rhs._surface_velocity;
+	_is_surface_dirty = rhs._is_surface_dirty;
 }
 
-MatrixXd RigidBody::GetSurfacePosition() const {
+void RigidBody::UpdateSurface() {
+	if (!_is_surface_dirty) {
+		return;
+	}
 	const auto& offsets = _shape->_offsets;
-	const auto& topo = _shape->_surface_topo;
 	const int num_vertices = offsets.size();
 
 	Vector3d center = GetCenter();
 	Matrix3d rotation = GetRotation();
-	MatrixXd position(num_vertices, 3);
+	_surface_position.resize(num_vertices, 3);
+	_surface_velocity.resize(num_vertices, 3);
 	for (int i = 0; i < num_vertices; i++) {
-		position.row(i) = rotation * offsets[i] + center;
+		const Vector3d position = rotation * offsets[i] + center;
+		_surface_position.row(i) = position.transpose();
+		_surface_velocity.row(i) = (GetJ(0, Vector3d::Zero(), position) * _v).transpose();
 	}
-	return position;
+	_is_surface_dirty = false;
+}
+
+RowMatrixX3dRef RigidBody::GetSurfacePosition() const {
+	return _surface_position;
+}
+
+RowMatrixX3dRef RigidBody::GetSurfaceVelocity() const {
+	return _surface_velocity;
 }
 
-Matrix<int, Dynamic, 3> RigidBody::GetSurfaceTopo() const {
+const Matrix<int, Dynamic, 3>& RigidBody::GetSurfaceTopo() const {
 	return _shape->_surface_topo;
 }
 
+void RigidBody::BuildBVH() {
+	const auto& offsets = _shape->_offsets;
+	const int num_vertices = offsets.size();
+	RowMatrixX3d local_position(num_vertices, 3);
+	for (int i = 0; i < num_vertices; i++) {
+		local_position.row(i) = offsets[i];
+	}
+	_bvh.Build(local_position, _shape->_surface_topo);
+}
+
+void RigidBody::GetBVHFrame(Matrix3d &rotation, Vector3d &translation) const {
+	rotation = GetRotation();
+	translation = GetCenter();
+}
+
+bool RigidBody::HasSignedDistance() const {
+	return _distance_field.IsBaked() || _shape->HasSignedDistance();
+}
+
+double RigidBody::SignedDistance(const Vector3d &point, Vector3d &gradient) const {
+	const Matrix3d rotation = GetRotation();
+	const Vector3d local_point = rotation.transpose() * (point - GetCenter());
+	Vector3d local_gradient;
+	const double distance = _distance_field.IsBaked() ? _distance_field.Query(local_point, local_gradient)
+													  : _shape->SignedDistance(local_point, local_gradient);
+	gradient = rotation * local_gradient;
+	return distance;
+}
+
+void RigidBody::BakeDistanceField(double cell_size) {
+	_distance_field.Bake(_shape->_offsets, _shape->_surface_topo, cell_size);
+	spdlog::info("Distance field baked, cell size {}", cell_size);
+}
+
 void RigidBody::Store(const std::string &filename,
 					  const OutputFormatType &format) const {
 	const auto& volume_topo = _shape->_volume_topo;
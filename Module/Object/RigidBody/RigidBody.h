@@ -9,6 +9,7 @@
 #include "Util/Pattern.h"
 #include "Object/Object.h"
 #include "Shape/Shape.h"
+#include "DistanceField.h"
 #include <string>
 #include <spdlog/spdlog.h>
 
@@ -18,12 +19,14 @@ public:
 
 	int GetDOF() const override = 0;
 	VectorXd & GetX() override {
+		_is_surface_dirty = true;
 		return _x;
 	}
 	const VectorXd & GetX() const override {
 		return _x;
 	}
 	VectorXd & GetV() override {
+		_is_surface_dirty = true;
 		return _v;
 	}
 	const VectorXd & GetV() const override {
@@ -52,9 +55,30 @@ public:
 		return _mu;
 	}
 
-	MatrixXd GetSurfacePosition() const override;
-	Matrix<int, Dynamic, 3> GetSurfaceTopo() const override;
-	SparseMatrixXd GetJ(int idx, const Vector3d &point) const override = 0;
+	// The world space surface is cached, and refreshed once the status has changed
+	RowMatrixX3dRef GetSurfacePosition() const override;
+	RowMatrixX3dRef GetSurfaceVelocity() const override;
+	const Matrix<int, Dynamic, 3>& GetSurfaceTopo() const override;
+	void UpdateSurface() override;
+
+	// The BVH is built on the shape, and moves with the body as a whole
+	void BuildBVH() override;
+	void UpdateBVH() override {}
+	void GetBVHFrame(Matrix3d &rotation, Vector3d &translation) const override;
+
+	// The signed distance of the shape, moved with the body, from the baked
+	// field if there is one, or else in closed form
+	bool HasSignedDistance() const override;
+	double SignedDistance(const Vector3d &point, Vector3d &gradient) const override;
+
+	/**
+	 * Sample the signed distance of the surface of the shape on a grid in
+	 * the frame of the body, for shapes without a closed form one
+	 * @param cell_size INPUT, the spacing of the grid
+	 */
+	void BakeDistanceField(double cell_size);
+
+	SparseMatrixXd GetJ(int idx, const Vector3d &barycentric, const Vector3d &point) const override = 0;
 	void Store(const std::string &filename, const OutputFormatType &format) const override;
 
 	RigidBody(const RigidBody& rhs);
@@ -69,6 +93,7 @@ protected:
 	double _mu;
 	double _rho;
 	const Shape* _shape;
+	DistanceField _distance_field;	// in the frame of the shape, empty unless baked
 
 	Vector3d _center;
 	Matrix3d _rotation;
@@ -76,6 +101,10 @@ protected:
 	VectorXd _x;
 	VectorXd _v;
 	COO _mass;
+
+	RowMatrixX3d _surface_position;		// world space, refreshed by UpdateSurface
+	RowMatrixX3d _surface_velocity;
+	bool _is_surface_dirty = true;
 };
 
 #endif //FEM_RIGIDBODY_H
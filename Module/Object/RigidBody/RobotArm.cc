@@ -16,10 +16,10 @@ RobotArm::RobotArm(double mu, double rho, const Vector3d &center,
 	_v.resize(1);
 	_x.setZero();
 	_v.setZero();
-
+	_collision_group = kRobotArmGroup;
 }
 
-SparseMatrixXd RobotArm::GetJ(int idx, const Vector3d &point) const {
+SparseMatrixXd RobotArm::GetJ(int idx, const Vector3d &barycentric, const Vector3d &point) const {
 	std::vector<Tripletd> coo;
 	for (int i = 0; i < 3; i++) {
 		coo.push_back(Tripletd(i, 0, _direction(i)));
@@ -27,4 +27,9 @@ SparseMatrixXd RobotArm::GetJ(int idx, const Vector3d &point) const {
 	SparseMatrixXd JT(3, 1);
 	JT.setFromTriplets(coo.begin(), coo.end());
 	return JT;
+}
+
+void RobotArm::AppendJ(int /*idx*/, const Vector3d &/*barycentric*/, const Vector3d &/*point*/, const Vector3d &direction,
+					   double weight, int row, int col_offset, COO &coo) const {
+	coo.push_back(Tripletd(row, col_offset, weight * direction.dot(_direction)));
 }
\ No newline at end of file
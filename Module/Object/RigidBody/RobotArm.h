@@ -30,7 +30,9 @@ public:
 		return _rotation;
 	}
 
-	SparseMatrixXd GetJ(int idx, const Vector3d &point) const override;
+	SparseMatrixXd GetJ(int idx, const Vector3d &barycentric, const Vector3d &point) const override;
+	void AppendJ(int idx, const Vector3d &barycentric, const Vector3d &point, const Vector3d &direction,
+				 double weight, int row, int col_offset, COO &coo) const override;
 
 	DERIVED_DECLARE_CLONE(Object)
 
@@ -4,4 +4,24 @@
 
 #include "Rectangle.h"
 
-DEFINE_CLONE(Shape, Rectangle)
\ No newline at end of file
+DEFINE_CLONE(Shape, Rectangle)
+
+double Rectangle::SignedDistance(const Vector3d &point, Vector3d &gradient) const {
+	const Vector3d q = point.cwiseAbs() - _half_size;
+	const Vector3d sign = point.unaryExpr([](double x) {
+		return x < 0 ? -1.0 : 1.0;
+	});
+	int axis;
+	const double max_q = q.maxCoeff(&axis);
+	if (max_q > 0) {
+		// outside, the nearest point is on a face, an edge or a corner
+		const Vector3d outside = q.cwiseMax(0);
+		const double distance = outside.norm();
+		gradient = sign.cwiseProduct(outside) / distance;
+		return distance;
+	}
+	// inside, the nearest point is on the closest face
+	gradient.setZero();
+	gradient(axis) = sign(axis);
+	return max_q;
+}
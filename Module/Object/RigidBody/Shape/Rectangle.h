@@ -17,7 +17,7 @@ using std::vector;
 
 struct Rectangle : public Shape {
 public:
-	Rectangle(const Vector3d& size) : Shape() {
+	Rectangle(const Vector3d& size) : Shape(), _half_size(size / 2) {
 		_offsets.resize(8);
 		for (int i = 0; i < 8; i++) {
 			for (int j = 0; j < 3; j++) {
@@ -57,7 +57,14 @@ public:
 		_volume = size[0] * size[1] * size[2];
 	}
 
+	bool HasSignedDistance() const override {
+		return true;
+	}
+	double SignedDistance(const Vector3d &point, Vector3d &gradient) const override;
+
 	DERIVED_DECLARE_CLONE(Shape)
+
+	Vector3d _half_size;	// half of the edge lengths
 };
 
 #endif //FEM_RECTANGLE_H
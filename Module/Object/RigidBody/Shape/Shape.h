@@ -19,6 +19,24 @@ struct Shape {
 
 	double _volume;
 
+	//-> whether the shape has a closed form signed distance
+	virtual bool HasSignedDistance() const {
+		return false;
+	}
+
+	/**
+	 * Signed distance of a point to the shape, negative inside
+	 * @param point INPUT, the point in the frame of the shape
+	 * @param gradient OUTPUT, the gradient of the distance, the outward
+	 * 		  normal at the nearest point of the surface
+	 */
+	virtual double SignedDistance(const Vector3d &/*point*/, Vector3d &gradient) const {
+		gradient.setZero();
+		return 0;
+	}
+
+	virtual ~Shape() = default;
+
 	BASE_DECLARE_CLONE(Shape)
 };
 
@@ -70,7 +70,9 @@ SoftBody::InternalEnergyHessianCOO(COO &coo, int x_offset, int y_offset) const {
 SoftBody::SoftBody(const SoftBody &rhs)
 	: Object(rhs), _mesh(rhs._mesh), _rest(rhs._rest),
 	_v(rhs._v), _mass(rhs._mass), _mass_coo(rhs._mass_coo),
-	_volume(rhs._volume), _inv(rhs._inv), _pFpX(rhs._pFpX), _mu(rhs._mu) {
+	_volume(rhs._volume), _inv(rhs._inv), _pFpX(rhs._pFpX), _mu(rhs._mu),
+	_surface_position(rhs._surface_position), _surface_velocity(rhs._surface_velocity),
+	_is_surface_dirty(rhs._is_surface_dirty) {
 	_body_energy = rhs._body_energy->Clone();
 }
 
@@ -89,24 +91,36 @@ void SoftBody::Initialize(const SoftBodyParameter &para) {
 	_mu = para.GetMu();
 }
 
-MatrixXd SoftBody::GetSurfacePosition() const {
-	const auto& vec_form = _mesh.GetPoints();
-	return Eigen::Map<const Eigen::Matrix<double, Dynamic, Dynamic, Eigen::RowMajor>>(vec_form.data(), vec_form.size() / 3, 3);
+void SoftBody::UpdateSurface() {
+	if (!_is_surface_dirty) {
+		return;
+	}
+	const auto& points = _mesh.GetPoints();
+	const auto& surface_points = _mesh.GetSurfacePoints();
+	const int num_surface_points = surface_points.size();
+	_surface_position.resize(num_surface_points, 3);
+	_surface_velocity.resize(num_surface_points, 3);
+	for (int i = 0; i < num_surface_points; i++) {
+		_surface_position.row(i) = points.segment<3>(3 * surface_points[i]).transpose();
+		_surface_velocity.row(i) = _v.segment<3>(3 * surface_points[i]).transpose();
+	}
+	_is_surface_dirty = false;
 }
 
-Matrix<int, Dynamic, 3> SoftBody::GetSurfaceTopo() const {
-	return _mesh.GetSurface();
+RowMatrixX3dRef SoftBody::GetSurfacePosition() const {
+	return _surface_position;
 }
 
-SparseMatrixXd SoftBody::GetJ(int idx, const Vector3d &point) const {
-	const auto& points = _mesh.GetPoints();
-	RowVector3i face = _mesh.GetSurface().row(idx);
-	Matrix3d X;
-	for (int i = 0; i < 3; i++) {
-		X.col(i) = points.block<3, 1>(3 * face[i], 0);
-	}
-	// TODO: need to be more robust
-	Vector3d barycentric = X.inverse() * point;	// barycentric coordinates
+RowMatrixX3dRef SoftBody::GetSurfaceVelocity() const {
+	return _surface_velocity;
+}
+
+const Matrix<int, Dynamic, 3>& SoftBody::GetSurfaceTopo() const {
+	return _mesh.GetCompactSurface();
+}
+
+SparseMatrixXd SoftBody::GetJ(int idx, const Vector3d &barycentric, const Vector3d &point) const {
+	const RowVector3i face = _mesh.GetSurface().row(idx);
 	COO coo;
 	for (int i = 0; i < 3; i++) {
 		for (int j = 0; j < 3; j++) {
@@ -118,6 +132,16 @@ SparseMatrixXd SoftBody::GetJ(int idx, const Vector3d &point) const {
 	return J;
 }
 
+void SoftBody::AppendJ(int idx, const Vector3d &barycentric, const Vector3d &point, const Vector3d &direction,
+					   double weight, int row, int col_offset, COO &coo) const {
+	const RowVector3i face = _mesh.GetSurface().row(idx);
+	for (int j = 0; j < 3; j++) {
+		for (int i = 0; i < 3; i++) {
+			coo.push_back(Tripletd(row, col_offset + 3 * face[j] + i, weight * direction(i) * barycentric[j]));
+		}
+	}
+}
+
 void SoftBody::Store(const std::string &filename,
 					 const OutputFormatType &format) const {
 	_mesh.Store(filename);
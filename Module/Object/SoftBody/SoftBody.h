@@ -57,6 +57,7 @@ struct SoftBody : public Object {
 	}
 
 	VectorXd & GetX() override {
+		_is_surface_dirty = true;
 		return _mesh.GetPoints();
 	}
 
@@ -65,6 +66,7 @@ struct SoftBody : public Object {
 	}
 
 	VectorXd & GetV() override {
+		_is_surface_dirty = true;
 		return _v;
 	}
 
@@ -80,9 +82,19 @@ struct SoftBody : public Object {
 		return _mu;
 	}
 
-	MatrixXd GetSurfacePosition() const override;
-	Matrix<int, Dynamic, 3> GetSurfaceTopo() const override;
-	SparseMatrixXd GetJ(int idx, const Vector3d &point) const override;
+	// Only the points on the surface, gathered into a cache refreshed once
+	// the status has changed, the topology indexes into them
+	RowMatrixX3dRef GetSurfacePosition() const override;
+	RowMatrixX3dRef GetSurfaceVelocity() const override;
+	const Matrix<int, Dynamic, 3>& GetSurfaceTopo() const override;
+	void UpdateSurface() override;
+	SparseMatrixXd GetJ(int idx, const Vector3d &barycentric, const Vector3d &point) const override;
+	void AppendJ(int idx, const Vector3d &barycentric, const Vector3d &point, const Vector3d &direction,
+				 double weight, int row, int col_offset, COO &coo) const override;
+
+	bool IsDeformable() const override {
+		return true;
+	}
 
 	void Store(const std::string &filename, const OutputFormatType &format) const override;
 
@@ -101,6 +113,10 @@ struct SoftBody : public Object {
 	BodyEnergy* _body_energy;
 	double _mu;
 
+	RowMatrixX3d _surface_position;		// of the surface points only, refreshed by UpdateSurface
+	RowMatrixX3d _surface_velocity;
+	bool _is_surface_dirty = true;
+
 	friend ExternalForce;
 };
 
@@ -5,6 +5,7 @@
 #include "Simulator.h"
 #include "Util/Factory.h"
 #include <spdlog/spdlog.h>
+#include "Util/Telemetry.h"
 
 DEFINE_ACCESSIBLE_MEMBER(SimulatorParameter, double, Duration, _duration)
 DEFINE_ACCESSIBLE_MEMBER(SimulatorParameter, double, Step, _step)
@@ -31,6 +32,7 @@ void Simulator::Initialize(const SimulatorParameter &para) {
 	_contact = ContactGeneratorFactory::GetInstance()->GetContactGenerator(
 			para.GetContactGenType());
 	_contact->Initialize(*para.GetContactGenPara());
+	_system.SetBVHRefit(_contact->UsesBVH());
 
 	_friction = FrictionModelFactory::GetInstance()->GetFrictionModel(
 			para.GetFrictionModelType());
@@ -48,7 +50,11 @@ void Simulator::Simulate() {
 	while(current < _duration) {
 		current += _step;
 		_output->StepCB(_system, index);
-		_integrator->Step(_system, *_contact, *_friction, _step);
+		TELEMETRY(SetFrame(index));
+		if (!_integrator->Step(_system, *_contact, *_friction, _step)) {
+			spdlog::error("Simulation stopped at frame {}", index);
+			break;
+		}
 		spdlog::info("Frame id: {}", index++);
 	}
 }
\ No newline at end of file
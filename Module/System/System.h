@@ -23,6 +23,14 @@ class System {
 public:
 	void Initialize(const SystemParameter& para) {}
 
+	/**
+	 * @param refit whether UpdateDynamic refits the BVHs of the objects,
+	 * 		  only contact generators reading them need it
+	 */
+	void SetBVHRefit(bool refit) {
+		_bvh_refit = refit;
+	}
+
 	const std::vector<Object*>& GetObjects() const {
 		return _objects;
 	}
@@ -79,7 +87,8 @@ public:
 		v.resize(_dof);
 		const int num_objects = _objects.size();
 		for (int i = 0; i < num_objects; i++) {
-			v.block(_dof_offsets[i], 0, _objects[i]->GetDOF(), 1) = _objects[i]->GetV();
+			const Object& object = *_objects[i];
+			v.block(_dof_offsets[i], 0, object.GetDOF(), 1) = object.GetV();
 		}
 	}
 
@@ -87,7 +96,8 @@ public:
 		x.resize(_dof);
 		const int num_objects = _objects.size();
 		for (int i = 0; i < num_objects; i++) {
-			x.block(_dof_offsets[i], 0, _objects[i]->GetDOF(), 1) = _objects[i]->GetX();
+			const Object& object = *_objects[i];
+			x.block(_dof_offsets[i], 0, object.GetDOF(), 1) = object.GetX();
 		}
 	}
 
@@ -151,6 +161,11 @@ public:
 			}
 		}
 		_mass.setFromTriplets(coo.begin(), coo.end());
+
+		for (auto& object : _objects) {
+			object->UpdateSurface();
+			object->BuildBVH();
+		}
 	}
 
 	/**
@@ -163,6 +178,10 @@ public:
 		for (int i = 0; i < num_objects; i++) {
 			_objects[i]->GetX() += u.block(_dof_offsets[i], 0, _objects[i]->GetDOF(), 1) * h;
 			_objects[i]->GetV() = u.block(_dof_offsets[i], 0, _objects[i]->GetDOF(), 1);
+			_objects[i]->UpdateSurface();
+			if (_bvh_refit) {
+				_objects[i]->UpdateBVH();
+			}
 		}
 	}
 
@@ -177,6 +196,7 @@ private:
 	std::vector<int> _dof_offsets;
 	SparseMatrixXd _mass;
 	int _dof;
+	bool _bvh_refit = true;
 };
 
 #endif //FEM_SYSTEM_H
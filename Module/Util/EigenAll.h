@@ -13,6 +13,8 @@
 using Eigen::Matrix;
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
+using Eigen::MatrixXf;
+using Eigen::VectorXf;
 using Eigen::Matrix3d;
 using Eigen::Vector3d;
 using Eigen::Matrix4d;
@@ -34,6 +36,8 @@ typedef Eigen::Vector<double, 1> Vector1d;
 typedef Eigen::SparseMatrix<double> SparseMatrixXd;
 typedef Eigen::Triplet<double> Tripletd;
 typedef std::vector<Tripletd> COO;
+typedef Eigen::Matrix<double, Dynamic, 3, Eigen::RowMajor> RowMatrixX3d;	// one point in a row, stored point by point
+typedef Eigen::Ref<const RowMatrixX3d> RowMatrixX3dRef;					// view of such points, a copy only for other layouts
 
 using Eigen::AngleAxisd;
 
@@ -35,30 +35,42 @@ END_DEFINE_XXX_FACTORY
 
 #include "Integrator/NonFricLCPIntegrator.h"
 #include "Integrator/StaggerLCPIntegrator.h"
+#include "Integrator/ConeIntegrator.h"
 BEGIN_DEFINE_XXX_FACTORY(Integrator)
 		ADD_PRODUCT(IntegratorType::kNonFrictionLCP, NonFricLCPIntegrator)
 		ADD_PRODUCT(IntegratorType::kStaggeringLCP, StaggerLCPIntegrator)
+		ADD_PRODUCT(IntegratorType::kCone, ConeIntegrator)
 END_DEFINE_XXX_FACTORY
 
 #include "NumericSolver/LCPSolver/PGS.h"
 #include "NumericSolver/LCPSolver/BGS.h"
 #include "NumericSolver/LCPSolver/PivotingMethod.h"
 #include "NumericSolver/LCPSolver/OSQPWrapper.h"
+#include "NumericSolver/LCPSolver/AdaptiveLCPSolver.h"
+#include "NumericSolver/LCPSolver/BoxQP.h"
 BEGIN_DEFINE_XXX_FACTORY(LCPSolver)
 		ADD_PRODUCT(LCPSolverType::kPGS, PGS)
 		ADD_PRODUCT(LCPSolverType::kBGS, BGS)
 		ADD_PRODUCT(LCPSolverType::kPivot, PivotingMethod)
 		ADD_PRODUCT(LCPSolverType::kOSQP, OSQPWrapper)
+		ADD_PRODUCT(LCPSolverType::kAdaptive, AdaptiveLCPSolver)
+		ADD_PRODUCT(LCPSolverType::kBoxQP, BoxQP)
 END_DEFINE_XXX_FACTORY
 
 #include "Contact/DCDContactGenerator.h"
+#include "Contact/SpatialHashContactGenerator.h"
+#include "Contact/CCDContactGenerator.h"
 BEGIN_DEFINE_XXX_FACTORY(ContactGenerator)
 		ADD_PRODUCT(ContactGeneratorType::kDCD, DCDContactGenerator)
+		ADD_PRODUCT(ContactGeneratorType::kSpatialHash, SpatialHashContactGenerator)
+		ADD_PRODUCT(ContactGeneratorType::kCCD, CCDContactGenerator)
 END_DEFINE_XXX_FACTORY
 
 #include "Contact/PolygonFrictionModel.h"
+#include "Contact/ConeFrictionModel.h"
 BEGIN_DEFINE_XXX_FACTORY(FrictionModel)
 		ADD_PRODUCT(FrictionModelType::kInscribedPolygon, PolygonFrictionModel)
+		ADD_PRODUCT(FrictionModelType::kCone, ConeFrictionModel)
 END_DEFINE_XXX_FACTORY
 
 #include "Contact/DCD/FastDCD.h"
@@ -0,0 +1,40 @@
+#include "Telemetry.h"
+#include <spdlog/spdlog.h>
+
+DEFINE_GET_INSTANCE(Telemetry)
+
+bool Telemetry::Open(const std::string &file) {
+	_output.open(file, std::ios::out | std::ios::trunc);
+	if (!_output.is_open()) {
+		spdlog::error("Cannot open {} for telemetry", file);
+		return false;
+	}
+	_output << "frame,source,event,iteration,value,time\n";
+	_enabled = true;
+	return true;
+}
+
+void Telemetry::Close() {
+	_enabled = false;
+	if (_output.is_open()) {
+		_output.close();
+	}
+}
+
+void Telemetry::Iteration(const char* source, int iteration, double residual) {
+	_output << _frame_id << ',' << source << ",iter," << iteration << ',' << residual << ",\n";
+}
+
+void Telemetry::Regularization(const char* source, int retry, double shift) {
+	_output << _frame_id << ',' << source << ",regularize," << retry << ',' << shift << ",\n";
+}
+
+void Telemetry::Solve(const char* source, int iterations, bool converged,
+					  double wall_time) {
+	_output << _frame_id << ',' << source << ",solve," << iterations << ','
+			<< (converged ? 1 : 0) << ',' << wall_time << '\n';
+}
+
+Telemetry::~Telemetry() {
+	Close();
+}
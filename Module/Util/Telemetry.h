@@ -0,0 +1,76 @@
+#ifndef FEM_TELEMETRY_H
+#define FEM_TELEMETRY_H
+
+#include "Pattern.h"
+#include <chrono>
+#include <fstream>
+#include <string>
+
+/**
+ * Telemetry of the numeric solvers, written as a csv stream with columns
+ * 		frame, source, event, iteration, value, time
+ * where event is one of
+ * 		iter:		value is the residual of the iteration
+ * 		regularize: iteration is the number of retries, value is the shift
+ * 		solve:		iteration is the total number of iterations, value is 1
+ * 					if converged and 0 otherwise, time is the wall time in ms
+ * When disabled, reporting costs a single branch, use the TELEMETRY macro.
+ */
+class Telemetry {
+public:
+	DECLARE_GET_INSTANCE(Telemetry)
+
+	/**
+	 * Enable the telemetry
+	 * @param file the csv file to write into, truncated if it exists
+	 */
+	bool Open(const std::string &file);
+	void Close();
+
+	static bool IsEnabled() {
+		return _enabled;
+	}
+
+	void SetFrame(int frame_id) {
+		_frame_id = frame_id;
+	}
+
+	void Iteration(const char* source, int iteration, double residual);
+	void Regularization(const char* source, int retry, double shift);
+	void Solve(const char* source, int iterations, bool converged, double wall_time);
+
+	~Telemetry();
+
+protected:
+	static inline bool _enabled = false;
+	int _frame_id = 0;
+	std::ofstream _output;
+};
+
+#define TELEMETRY(call) do { if (Telemetry::IsEnabled()) { Telemetry::GetInstance()->call; } } while (0)
+
+/**
+ * Measure the wall time of a solve and report its summary
+ */
+class TelemetryScope {
+public:
+	explicit TelemetryScope(const char* source) : _source(source) {
+		if (Telemetry::IsEnabled()) {
+			_start = std::chrono::steady_clock::now();
+		}
+	}
+
+	void Finish(int iterations, bool converged) const {
+		if (Telemetry::IsEnabled()) {
+			const auto end = std::chrono::steady_clock::now();
+			Telemetry::GetInstance()->Solve(_source, iterations, converged,
+				std::chrono::duration<double, std::milli>(end - _start).count());
+		}
+	}
+
+protected:
+	const char* _source;
+	std::chrono::steady_clock::time_point _start;
+};
+
+#endif //FEM_TELEMETRY_H
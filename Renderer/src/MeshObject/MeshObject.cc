@@ -7,7 +7,7 @@ MeshObject::MeshObject() {
     glGenVertexArrays(1, &_VAO);
 }
 
-void MeshObject::SetMesh(const MatrixXd &vertices, const MatrixXi &topos) {
+void MeshObject::SetMesh(const RowMatrixX3dRef &vertices, const Eigen::Ref<const Matrix<int, Dynamic, 3>> &topos) {
     // TODO: make this more efficient
     if (_vertex_array_data.rows() != topos.size() || _vertex_array_data.cols() != 6) {
         _vertex_array_data.resize(topos.size(), 6);
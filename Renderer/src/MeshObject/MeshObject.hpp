@@ -13,7 +13,7 @@ public:
     MeshObject(const MeshObject& mesh);
     MeshObject& operator=(const MeshObject& mesh) = delete;
 
-    void SetMesh(const MatrixXd& vertices, const MatrixXi& topos);
+    void SetMesh(const RowMatrixX3dRef& vertices, const Eigen::Ref<const Matrix<int, Dynamic, 3>>& topos);
 
     void Bind();
     void Draw();
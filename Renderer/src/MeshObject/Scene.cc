@@ -13,7 +13,7 @@ void Scene::SelectData(int idx) {
     _selected_data = idx;
 }
 
-void Scene::SetMesh(const MatrixXd &vertices, const MatrixXi &topo) {
+void Scene::SetMesh(const RowMatrixX3dRef &vertices, const Eigen::Ref<const Matrix<int, Dynamic, 3>> &topo) {
     if (_selected_data == -1) {
         spdlog::error("Try to access an invalid id");
         return;
@@ -28,9 +28,10 @@ public:
 
     /**
      * @brief Set the Mesh for the seleted mesh
-     * 
+     * @note Views of row major vertices and of the triangles are
+     *       read in place
      */
-    void SetMesh(const MatrixXd& vertices, const MatrixXi& topo);
+    void SetMesh(const RowMatrixX3dRef& vertices, const Eigen::Ref<const Matrix<int, Dynamic, 3>>& topo);
 
 private:
     std::vector<MeshObject> _meshes;
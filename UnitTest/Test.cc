@@ -61,6 +61,28 @@ int main() {
 //	suite.addTest(new CppUnit::TestCaller<Test>("Test Optimizer", &Test::TestOptimizerCG));
 //	suite.addTest(new CppUnit::TestCaller<Test>("Test LCP NumericSolver", &Test::TestLCPCommon));
 	suite.addTest(new CppUnit::TestCaller<Test>("Test LCP NumericSolver for friction", &Test::TestLCPFrictionMatrix));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test LCP operators", &Test::TestLCPOperator));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test mixed precision PGS", &Test::TestLCPMixedPrecision));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test Anderson accelerated staggering", &Test::TestAndersonAcceleration));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test fallback of the adaptive LCP solver", &Test::TestAdaptiveFallback));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test box QP solver", &Test::TestBoxQP));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test cone PGS solver", &Test::TestConePGS));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test bounding volume hierarchy", &Test::TestBVH));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test bounding volume hierarchy against itself", &Test::TestBVHSelfIntersect));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test sweep and prune", &Test::TestSweepAndPrune));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test parallel contact generation", &Test::TestContactGenerator));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test cached candidate pairs", &Test::TestCandidateCache));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test spatial hashing contact generator", &Test::TestSpatialHash));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test continuous collision detection", &Test::TestCCD));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test contact reduction", &Test::TestContactReduction));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test cached rigid body surface", &Test::TestRigidSurface));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test compact soft body surface", &Test::TestSoftSurface));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test batched triangle intersection", &Test::TestBatchedDCD));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test signed distance of boxes", &Test::TestBoxDistance));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test analytic contacts against boxes", &Test::TestAnalyticContact));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test baked distance fields", &Test::TestDistanceField));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test friction Jacobian assembly", &Test::TestFrictionJacobian));
+	suite.addTest(new CppUnit::TestCaller<Test>("Test contact compliance", &Test::TestContactCompliance));
 //	suite.addTest(new CppUnit::TestCaller<Test>("Test Optimizer with constraints", &Test::TestOptimizerCons));
 //	suite.addTest(new CppUnit::TestCaller<Test>("Test Constitute Model", &Test::TestConstituteModel));
 //	suite.addTest(new CppUnit::TestCaller<Test>("Test Elastic Energy Model", &Test::TestElasticForce));
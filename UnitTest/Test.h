@@ -34,6 +34,28 @@ public:
 	void TestLCPCommon();
 	void TestLCPFrictionMatrix();
 	void TestLCPSmallScale();
+	void TestLCPOperator();
+	void TestLCPMixedPrecision();
+	void TestAndersonAcceleration();
+	void TestAdaptiveFallback();
+	void TestBoxQP();
+	void TestConePGS();
+	void TestBVH();
+	void TestBVHSelfIntersect();
+	void TestSweepAndPrune();
+	void TestContactGenerator();
+	void TestCandidateCache();
+	void TestSpatialHash();
+	void TestCCD();
+	void TestContactReduction();
+	void TestRigidSurface();
+	void TestSoftSurface();
+	void TestBatchedDCD();
+	void TestBoxDistance();
+	void TestAnalyticContact();
+	void TestDistanceField();
+	void TestFrictionJacobian();
+	void TestContactCompliance();
 	void TestRigidBodyContact();
 
 private:
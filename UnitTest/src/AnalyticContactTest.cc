@@ -0,0 +1,101 @@
+#include "../Test.h"
+#include "Contact/DCDContactGenerator.h"
+#include "Contact/SpatialHashContactGenerator.h"
+#include "Fixture.h"
+
+void Test::TestBoxDistance() {
+	Rectangle box(Vector3d(1, 2, 4));
+	Vector3d gradient;
+	// inside, to the nearest face
+	CPPUNIT_ASSERT(std::abs(box.SignedDistance(Vector3d(0, 0, -1.8), gradient) + 0.2) < _eps);
+	CPPUNIT_ASSERT(gradient == Vector3d(0, 0, -1));
+	// outside, from a face and from a corner
+	CPPUNIT_ASSERT(std::abs(box.SignedDistance(Vector3d(1.5, 0.5, 0), gradient) - 1) < _eps);
+	CPPUNIT_ASSERT(gradient == Vector3d(1, 0, 0));
+	CPPUNIT_ASSERT(std::abs(box.SignedDistance(Vector3d(-1.5, 2, 3), gradient) - std::sqrt(3)) < _eps);
+	CPPUNIT_ASSERT((gradient - Vector3d(-1, 1, 1).normalized()).norm() < _eps);
+
+	// moved with the body
+	RobotArm arm = RotatedBox();
+	const Matrix3d rotation = arm.GetRotation();
+	CPPUNIT_ASSERT(arm.HasSignedDistance());
+	CPPUNIT_ASSERT(std::abs(arm.SignedDistance(arm.GetCenter() + rotation * Vector3d(0.6, 0, 0), gradient) - 0.1) < _eps);
+	CPPUNIT_ASSERT((gradient - rotation.col(0)).norm() < _eps);
+}
+
+void Test::TestAnalyticContact() {
+	const SoftBody soft_body = BunnySoftBody();
+	const RowMatrixX3d vertices = soft_body.GetSurfacePosition();
+	const Vector3d lower = vertices.colwise().minCoeff(), upper = vertices.colwise().maxCoeff();
+
+	// a slab holding the bottom fifth of the bunny
+	const double height = upper.z() - lower.z();
+	const Vector3d center((lower.x() + upper.x()) / 2, (lower.y() + upper.y()) / 2, lower.z());
+	const Vector3d size(2 * (upper.x() - lower.x()), 2 * (upper.y() - lower.y()), 0.4 * height);
+	System system;
+	system.AddObject(soft_body);
+	system.AddObject(RobotArm(0.5, 1, center, Vector3d::Zero(), size, Vector3d(0, 0, 1)));
+	system.UpdateSettings();
+
+	DCDContactGenerator bvh_generator;
+	bvh_generator.Initialize(DCDContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6), false, 0, RigidContactType::kAnalytic));
+	SpatialHashContactGenerator hash_generator;
+	hash_generator.Initialize(SpatialHashContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6), 1, 0, RigidContactType::kAnalytic));
+
+	// every vertex inside is a contact, pushed straight up by its depth
+	int num_inside = 0;
+	for (int i = 0; i < vertices.rows(); i++) {
+		num_inside += vertices(i, 2) < lower.z() + 0.2 * height;
+	}
+	CPPUNIT_ASSERT(num_inside > 0);
+	vector<ContactPoint> expected, contacts;
+	bvh_generator.GetContact(system, expected);
+	hash_generator.GetContact(system, contacts);
+	CPPUNIT_ASSERT(expected.size() == num_inside);
+	CPPUNIT_ASSERT(contacts.size() == num_inside);
+	for (int i = 0; i < num_inside; i++) {
+		CPPUNIT_ASSERT(expected[i]._obj1 == 1 && expected[i]._obj2 == 0 && expected[i]._idx1 == -1);
+		CPPUNIT_ASSERT((expected[i]._normal - Vector3d(0, 0, 1)).norm() < _eps);
+		CPPUNIT_ASSERT(std::abs(expected[i]._point.z() + expected[i]._depth - lower.z() - 0.2 * height) < 1e-10);
+		CPPUNIT_ASSERT(expected[i]._point == contacts[i]._point && expected[i]._idx2 == contacts[i]._idx2);
+		// a vertex of the face the contact is on
+		const Vector3d& barycentric = expected[i]._barycentric2;
+		CPPUNIT_ASSERT(barycentric.maxCoeff() == 1 && barycentric.sum() == 1);
+		CPPUNIT_ASSERT(expected[i]._barycentric1 == Vector3d::Zero() && barycentric == contacts[i]._barycentric2);
+		Vector3d point = Vector3d::Zero();
+		for (int j = 0; j < 3; j++) {
+			point += barycentric(j) * vertices.row(soft_body.GetSurfaceTopo()(expected[i]._idx2, j)).transpose();
+		}
+		CPPUNIT_ASSERT(point == expected[i]._point);
+	}
+}
+
+void Test::TestDistanceField() {
+	const RobotArm box = RotatedBox();
+	RobotArm baked(box);
+	const double cell_size = 0.02;
+	baked.BakeDistanceField(cell_size);
+	CPPUNIT_ASSERT(baked.HasSignedDistance());
+
+	// close to the closed form near the surface, with the same sign deep inside and far away
+	srand(0);
+	int num_near = 0;
+	for (int i = 0; i < 1000; i++) {
+		const Vector3d point = box.GetCenter() + Vector3d::Random();
+		Vector3d expected_gradient, gradient;
+		const double expected = box.SignedDistance(point, expected_gradient);
+		const double distance = baked.SignedDistance(point, gradient);
+		CPPUNIT_ASSERT((expected < 0) == (distance < 0));
+		if (std::abs(expected) < 2 * cell_size) {
+			num_near++;
+			CPPUNIT_ASSERT(std::abs(distance - expected) < cell_size);
+		}
+	}
+	CPPUNIT_ASSERT(num_near > 0);
+
+	// the gradient is the normal in the middle of a face
+	Vector3d gradient;
+	const Matrix3d rotation = box.GetRotation();
+	baked.SignedDistance(box.GetCenter() + rotation * Vector3d(0.01, 0.02, 0.24), gradient);
+	CPPUNIT_ASSERT((gradient - rotation.col(2)).norm() < 1e-6);
+}
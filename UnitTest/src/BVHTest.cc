@@ -0,0 +1,161 @@
+#include "../Test.h"
+#include "Contact/BVH/BVH.h"
+#include "Contact/DCD/FastDCD.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+	//-> a soup of small triangles scattered in a unit box around offset
+	void RandomSurface(int num_faces, const Vector3d &offset, MatrixXd &vertices, Matrix<int, Dynamic, 3> &topo) {
+		vertices.resize(3 * num_faces, 3);
+		topo.resize(num_faces, 3);
+		for (int i = 0; i < num_faces; i++) {
+			const Eigen::RowVector3d center = Eigen::RowVector3d::Random() + offset.transpose();
+			for (int j = 0; j < 3; j++) {
+				vertices.row(3 * i + j) = center + 0.1 * Eigen::RowVector3d::Random();
+				topo(i, j) = 3 * i + j;
+			}
+		}
+	}
+
+	//-> pairs of triangles with overlapping boxes
+	std::vector<std::pair<int, int>> BruteForce(const MatrixXd &vertices1, const Matrix<int, Dynamic, 3> &topo1,
+												const MatrixXd &vertices2, const Matrix<int, Dynamic, 3> &topo2) {
+		std::vector<std::pair<int, int>> pairs;
+		for (int i = 0; i < topo1.rows(); i++) {
+			AABB box1;
+			for (int k = 0; k < 3; k++) {
+				box1.Extend(vertices1.row(topo1(i, k)).transpose());
+			}
+			for (int j = 0; j < topo2.rows(); j++) {
+				AABB box2;
+				for (int k = 0; k < 3; k++) {
+					box2.Extend(vertices2.row(topo2(j, k)).transpose());
+				}
+				if (box1.Overlap(box2)) {
+					pairs.emplace_back(i, j);
+				}
+			}
+		}
+		return pairs;
+	}
+}
+
+void Test::TestBVH() {
+	const int num_faces = 500;
+	MatrixXd vertices1, vertices2;
+	Matrix<int, Dynamic, 3> topo1, topo2;
+	RandomSurface(num_faces, Vector3d::Zero(), vertices1, topo1);
+	RandomSurface(num_faces, Vector3d(0.5, 0, 0), vertices2, topo2);
+
+	BVH bvh1, bvh2;
+	bvh1.Build(vertices1, topo1);
+	bvh2.Build(vertices2, topo2);
+	std::vector<std::pair<int, int>> pairs;
+	bvh1.Intersect(bvh2, pairs);
+
+	CPPUNIT_ASSERT(pairs == BruteForce(vertices1, topo1, vertices2, topo2));
+	CPPUNIT_ASSERT(!pairs.empty());
+
+	// refitting after a deformation finds the same pairs as a rebuild
+	vertices2 += 0.05 * MatrixXd::Random(vertices2.rows(), 3);
+	bvh2.Refit(vertices2);
+	bvh1.Intersect(bvh2, pairs);
+	CPPUNIT_ASSERT(pairs == BruteForce(vertices1, topo1, vertices2, topo2));
+
+	// trees built in different frames, the candidates only grow
+	const Matrix3d rotation = Eigen::AngleAxisd(0.3, Vector3d(1, 2, 3).normalized()).toRotationMatrix();
+	const Vector3d translation(0.2, -0.1, 0.3);
+	MatrixXd local2 = (vertices2.rowwise() - translation.transpose()) * rotation;
+	BVH local_bvh2;
+	local_bvh2.Build(local2, topo2);
+	bvh1.Intersect(local_bvh2, rotation, translation, pairs);
+	const auto expected = BruteForce(vertices1, topo1, (local2 * rotation.transpose()).rowwise() + translation.transpose(), topo2);
+	CPPUNIT_ASSERT(std::includes(pairs.begin(), pairs.end(), expected.begin(), expected.end()));
+
+	// far apart surfaces produce no candidates at all
+	RandomSurface(num_faces, Vector3d(10, 0, 0), vertices2, topo2);
+	bvh2.Build(vertices2, topo2);
+	bvh1.Intersect(bvh2, pairs);
+	CPPUNIT_ASSERT(pairs.empty());
+}
+
+namespace {
+	//-> a strip along the profile in the xz plane, extruded along y
+	void Extrude(const std::vector<Vector3d> &profile, int num_y, MatrixXd &vertices, Matrix<int, Dynamic, 3> &topo) {
+		const int num_profile = profile.size();
+		vertices.resize(num_profile * num_y, 3);
+		for (int i = 0; i < num_profile; i++) {
+			for (int j = 0; j < num_y; j++) {
+				vertices.row(i * num_y + j) = (profile[i] + Vector3d(0, 0.1 * j, 0)).transpose();
+			}
+		}
+		topo.resize(2 * (num_profile - 1) * (num_y - 1), 3);
+		int face = 0;
+		for (int i = 0; i + 1 < num_profile; i++) {
+			for (int j = 0; j + 1 < num_y; j++) {
+				const int a = i * num_y + j, b = (i + 1) * num_y + j;
+				topo.row(face++) << a, b, a + 1;
+				topo.row(face++) << a + 1, b, b + 1;
+			}
+		}
+	}
+
+	Vector3d Normal(const MatrixXd &vertices, const Matrix<int, Dynamic, 3> &topo, int i) {
+		const Vector3d a = vertices.row(topo(i, 0)), b = vertices.row(topo(i, 1)), c = vertices.row(topo(i, 2));
+		return (b - a).cross(c - a).normalized();
+	}
+}
+
+void Test::TestBVHSelfIntersect() {
+	// a flat sheet never touches itself, and its normal cones cull everything
+	std::vector<Vector3d> profile;
+	for (int i = 0; i <= 40; i++) {
+		profile.emplace_back(0.05 * i, 0, 0);
+	}
+	MatrixXd vertices;
+	Matrix<int, Dynamic, 3> topo;
+	Extrude(profile, 20, vertices, topo);
+	BVH bvh;
+	bvh.Build(vertices, topo);
+	std::vector<std::pair<int, int>> pairs;
+	bvh.SelfIntersect(pairs);
+	CPPUNIT_ASSERT(pairs.empty());
+
+	// folding the sheet back through itself
+	for (int i = 1; i <= 10; i++) {
+		const double theta = M_PI * i / 10;
+		profile.emplace_back(2 + 0.25 * std::sin(theta), 0, 0.25 - 0.25 * std::cos(theta));
+	}
+	for (int i = 1; i <= 40; i++) {
+		profile.emplace_back(2 - 0.06 * i, 0, 0.5 - 0.021 * i);
+	}
+	Extrude(profile, 20, vertices, topo);
+	bvh.Build(vertices, topo);
+	bvh.SelfIntersect(pairs);
+
+	// every crossing of the two layers is a candidate, coplanar pairs are
+	// left out as the triangle test reports false positives on them
+	FastDCD dcd;
+	const DCD &narrow_phase = dcd;
+	int num_intersected = 0;
+	for (int i = 0; i < topo.rows(); i++) {
+		const Vector3d normal_i = Normal(vertices, topo, i);
+		for (int j = i + 1; j < topo.rows(); j++) {
+			bool adjacent = false;
+			for (int k = 0; k < 9; k++) {
+				adjacent = adjacent || topo(i, k / 3) == topo(j, k % 3);
+			}
+			const Vector3d normal_j = Normal(vertices, topo, j);
+			Vector3d point, normal;
+			if (!adjacent && std::abs(normal_i.dot(normal_j)) < 0.99 && narrow_phase.GetIntersected(
+					vertices.row(topo(i, 0)), vertices.row(topo(i, 1)), vertices.row(topo(i, 2)),
+					vertices.row(topo(j, 0)), vertices.row(topo(j, 1)), vertices.row(topo(j, 2)),
+					point, normal)) {
+				num_intersected++;
+				CPPUNIT_ASSERT(std::binary_search(pairs.begin(), pairs.end(), std::make_pair(i, j)));
+			}
+		}
+	}
+	CPPUNIT_ASSERT(num_intersected > 0);
+}
@@ -0,0 +1,142 @@
+#include "../Test.h"
+#include "Contact/DCDContactGenerator.h"
+#include "Contact/SpatialHashContactGenerator.h"
+#include "Contact/CCDContactGenerator.h"
+#include "Fixture.h"
+#include <omp.h>
+
+void Test::TestContactGenerator() {
+	System system;
+	AddArmRow(system);
+
+	DCDContactGenerator generator;
+	generator.Initialize(DCDContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6)));
+
+	// the contacts do not depend on the number of threads
+	vector<ContactPoint> serial, parallel;
+	const int num_threads = omp_get_max_threads();
+	omp_set_num_threads(1);
+	generator.GetContact(system, serial);
+	omp_set_num_threads(4);
+	generator.GetContact(system, parallel);
+	omp_set_num_threads(num_threads);
+
+	CPPUNIT_ASSERT(!serial.empty());
+	CPPUNIT_ASSERT(serial.size() == parallel.size());
+	for (int i = 0; i < serial.size(); i++) {
+		CPPUNIT_ASSERT(serial[i]._obj1 == parallel[i]._obj1 && serial[i]._obj2 == parallel[i]._obj2);
+		CPPUNIT_ASSERT(serial[i]._idx1 == parallel[i]._idx1 && serial[i]._idx2 == parallel[i]._idx2);
+		CPPUNIT_ASSERT(serial[i]._point == parallel[i]._point);
+	}
+
+	// the weights put the point on both faces
+	const auto& objects = system.GetObjects();
+	for (const auto& contact : serial) {
+		const int objs[2] = {contact._obj1, contact._obj2}, faces[2] = {contact._idx1, contact._idx2};
+		const Vector3d barycentrics[2] = {contact._barycentric1, contact._barycentric2};
+		for (int side = 0; side < 2; side++) {
+			const auto vertices = objects[objs[side]]->GetSurfacePosition();
+			const auto topo = objects[objs[side]]->GetSurfaceTopo();
+			Vector3d point = Vector3d::Zero();
+			for (int j = 0; j < 3; j++) {
+				point += barycentrics[side](j) * vertices.row(topo(faces[side], j)).transpose();
+			}
+			CPPUNIT_ASSERT(std::abs(barycentrics[side].sum() - 1) < 1e-10);
+			CPPUNIT_ASSERT((point - contact._point).norm() < 1e-8);
+		}
+	}
+}
+
+void Test::TestCandidateCache() {
+	System system;
+	AddArmRow(system);
+
+	DCDContactGenerator generator, cached_generator;
+	generator.Initialize(DCDContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6)));
+	cached_generator.Initialize(DCDContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6), false, 0,
+															  RigidContactType::kTriangle, 4));
+
+	// the cached candidates find the same contacts while the arms drift apart and back
+	srand(0);
+	const VectorXd v = VectorXd::Random(system.GetSysDOF());
+	for (int step = 0; step < 40; step++) {
+		vector<ContactPoint> expected, contacts;
+		generator.GetContact(system, expected);
+		cached_generator.GetContact(system, contacts);
+		CPPUNIT_ASSERT(!expected.empty());
+		CPPUNIT_ASSERT(expected.size() == contacts.size());
+		for (int i = 0; i < expected.size(); i++) {
+			CPPUNIT_ASSERT(expected[i]._obj1 == contacts[i]._obj1 && expected[i]._obj2 == contacts[i]._obj2);
+			CPPUNIT_ASSERT(expected[i]._idx1 == contacts[i]._idx1 && expected[i]._idx2 == contacts[i]._idx2);
+			CPPUNIT_ASSERT(expected[i]._point == contacts[i]._point);
+		}
+		system.UpdateDynamic(step < 20 ? v : VectorXd(-v), 0.005);
+	}
+}
+
+void Test::TestSpatialHash() {
+	System system;
+	for (int i = 0; i < 60; i++) {
+		const Vector3d center = 3 * Vector3d::Random(), euler_angles = 3 * Vector3d::Random();
+		const Vector3d size = Vector3d::Constant(0.5) + 0.3 * Vector3d::Random();
+		system.AddObject(RobotArm(0.5, 1, center, euler_angles, size, Vector3d(1, 0, 0)));
+	}
+	// triangles too large for the grid
+	system.AddObject(RobotArm(0.5, 1, Vector3d::Zero(), Vector3d(0.1, 0.2, 0.3), Vector3d(10, 10, 0.3), Vector3d(1, 0, 0)));
+	system.UpdateSettings();
+
+	DCDContactGenerator bvh_generator;
+	bvh_generator.Initialize(DCDContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6)));
+	SpatialHashContactGenerator hash_generator;
+	hash_generator.Initialize(SpatialHashContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6)));
+
+	// both broad phases find exactly the same contacts
+	vector<ContactPoint> expected, contacts;
+	bvh_generator.GetContact(system, expected);
+	hash_generator.GetContact(system, contacts);
+	CPPUNIT_ASSERT(!expected.empty());
+	CPPUNIT_ASSERT(expected.size() == contacts.size());
+	for (int i = 0; i < expected.size(); i++) {
+		CPPUNIT_ASSERT(expected[i]._obj1 == contacts[i]._obj1 && expected[i]._obj2 == contacts[i]._obj2);
+		CPPUNIT_ASSERT(expected[i]._idx1 == contacts[i]._idx1 && expected[i]._idx2 == contacts[i]._idx2);
+		CPPUNIT_ASSERT(expected[i]._point == contacts[i]._point);
+	}
+}
+
+void Test::TestCCD() {
+	System system;
+	// a thin wall, and a box which passes through it within one step
+	system.AddObject(RobotArm(0.5, 1, Vector3d::Zero(), Vector3d::Zero(), Vector3d(0.05, 2, 2), Vector3d(1, 0, 0)));
+	system.AddObject(RobotArm(0.5, 1, Vector3d(-1, 0, 0), Vector3d(0.1, 0.2, 0.3), Vector3d(0.5, 0.5, 0.5), Vector3d(1, 0, 0)));
+	system.UpdateSettings();
+	const double time_step = 0.02;
+
+	DCDContactGenerator dcd_generator;
+	dcd_generator.Initialize(DCDContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6)));
+	CCDContactGenerator ccd_generator;
+	ccd_generator.Initialize(CCDContactGeneratorParameter(time_step, 1e-6, 100));
+
+	vector<ContactPoint> contacts;
+	system.GetObjects()[1]->GetV()(0) = 100;
+	system.GetObjects()[1]->UpdateSurface();
+	dcd_generator.GetContact(system, contacts);
+	CPPUNIT_ASSERT(contacts.empty());
+	ccd_generator.GetContact(system, contacts);
+	CPPUNIT_ASSERT(!contacts.empty());
+	for (const auto& contact : contacts) {
+		// normal from the box to the wall, against the motion
+		CPPUNIT_ASSERT(contact._obj1 == 1 && contact._obj2 == 0);
+		CPPUNIT_ASSERT(contact._normal(0) > 0);
+		CPPUNIT_ASSERT(contact._point(0) < 0);
+		// apart now, and closer than the box moves within the step
+		CPPUNIT_ASSERT(contact._gap > 0 && contact._gap < 100 * time_step);
+		CPPUNIT_ASSERT(std::abs(contact._barycentric1.sum() - 1) < 1e-10);
+		CPPUNIT_ASSERT(std::abs(contact._barycentric2.sum() - 1) < 1e-10);
+	}
+
+	// too slow to reach the wall within the step
+	system.GetObjects()[1]->GetV()(0) = 10;
+	system.GetObjects()[1]->UpdateSurface();
+	ccd_generator.GetContact(system, contacts);
+	CPPUNIT_ASSERT(contacts.empty());
+}
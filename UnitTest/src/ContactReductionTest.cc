@@ -0,0 +1,49 @@
+#include "../Test.h"
+#include "Contact/ContactGenerator.h"
+
+void Test::TestContactReduction() {
+	vector<ContactPoint> contacts;
+	// a patch of 10 x 10 contacts, two contacts on a side, a parallel patch
+	// apart from it with a deeper contact inside, and another pair
+	for (int i = 0; i < 10; i++) {
+		for (int j = 0; j < 10; j++) {
+			contacts.emplace_back(1, 0, i, j, Vector3d(i, j, 0), Vector3d(0, 0.01 * i, 1).normalized());
+		}
+		if (i < 2) {
+			contacts.emplace_back(1, 0, i, 0, Vector3d(i, 0, 1), Vector3d(1, 0, 0));
+		}
+	}
+	for (int i = 0; i < 10; i++) {
+		for (int j = 0; j < 10; j++) {
+			contacts.emplace_back(1, 0, i, j, Vector3d(20 + i, j, 0), Vector3d(0, 0, 1));
+		}
+	}
+	contacts[contacts.size() - 56]._depth = 0.1;
+	contacts.emplace_back(2, 0, 0, 0, Vector3d::Zero(), Vector3d(0, 0, 1));
+
+	ContactReduction reduction;
+	reduction.Initialize(4);
+	reduction.Reduce(contacts);
+
+	// the corners of the patch stand for it, the deepest contact and the
+	// ones spread around it for the other patch, the rest is kept as is
+	CPPUNIT_ASSERT(contacts.size() == 11);
+	const Vector3d corners[4] = {Vector3d(0, 0, 0), Vector3d(0, 9, 0), Vector3d(9, 0, 0), Vector3d(9, 9, 0)};
+	const Vector3d deep_points[4] = {Vector3d(20, 9, 0), Vector3d(24, 4, 0), Vector3d(29, 0, 0), Vector3d(29, 9, 0)};
+	int num_corners = 0, num_deep_points = 0;
+	for (const auto& contact : contacts) {
+		if (contact._normal.z() > 0.9 && contact._obj1 == 1) {
+			if (contact._point.x() < 10) {
+				CPPUNIT_ASSERT(contact._point == corners[num_corners++]);
+			} else {
+				CPPUNIT_ASSERT(contact._point == deep_points[num_deep_points++]);
+			}
+			CPPUNIT_ASSERT(std::abs(contact._weight - 5) < _eps);
+			CPPUNIT_ASSERT(contact._normal.x() == 0 && std::abs(contact._normal.norm() - 1) < _eps);
+		} else {
+			CPPUNIT_ASSERT(contact._weight == 1);
+		}
+	}
+	CPPUNIT_ASSERT(num_corners == 4 && num_deep_points == 4);
+	CPPUNIT_ASSERT(contacts.back()._obj1 == 2);
+}
@@ -0,0 +1,42 @@
+#include "../Test.h"
+#include "Contact/DCD/FastDCD.h"
+#include <random>
+
+void Test::TestBatchedDCD() {
+	// random triangles in a small box, some crossing, some apart, and a
+	// size that is not a multiple of the lanes
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<double> distribution(-1, 1);
+	const int size = 1001;
+	TrianglePairBatch batch;
+	batch.Resize(size);
+	for (int i = 0; i < size; i++) {
+		const Vector3d shift = Vector3d::Constant(i % 3 == 0 ? 2.5 : 0);
+		for (int v = 0; v < 3; v++) {
+			batch.SetFirst(i, v, Vector3d(distribution(generator), distribution(generator), distribution(generator)));
+			batch.SetSecond(i, v, Vector3d(distribution(generator), distribution(generator), distribution(generator)) + shift);
+		}
+	}
+
+	FastDCD dcd;
+	const DCD &narrow_phase = dcd;
+	std::vector<int> hits;
+	std::vector<Vector3d> points, normals;
+	narrow_phase.GetIntersected(batch, hits, points, normals);
+	CPPUNIT_ASSERT(hits.size() == points.size() && hits.size() == normals.size());
+	CPPUNIT_ASSERT(!hits.empty() && hits.size() < size);
+
+	// the same hits, points and normals as the pairs tested one by one
+	int num_hits = 0;
+	for (int i = 0; i < size; i++) {
+		Vector3d point, normal;
+		if (narrow_phase.GetIntersected(batch.GetFirst(i, 0), batch.GetFirst(i, 1), batch.GetFirst(i, 2),
+										batch.GetSecond(i, 0), batch.GetSecond(i, 1), batch.GetSecond(i, 2),
+										point, normal)) {
+			CPPUNIT_ASSERT(num_hits < hits.size() && hits[num_hits] == i);
+			CPPUNIT_ASSERT(points[num_hits] == point && normals[num_hits] == normal);
+			num_hits++;
+		}
+	}
+	CPPUNIT_ASSERT(num_hits == hits.size());
+}
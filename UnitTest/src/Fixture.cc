@@ -0,0 +1,32 @@
+#include "Fixture.h"
+#include "BodyEnergy/BodyEnergy.h"
+#include "ElementEnergy/SimpleModel.h"
+#include "ElementEnergy/RayleighModel.h"
+#include "ConstituteModel/StVKModel.h"
+#include "Mass/VoronoiModel.h"
+
+SoftBody BunnySoftBody() {
+	Mesh mesh;
+	mesh.Initialize(MeshParameter("../Resource/vtk/bunny.vtk"));
+	SoftBody soft_body(mesh);
+	soft_body.Initialize(SoftBodyParameter(
+		1, MassModelType::kVoronoi, VoronoiModelParameter(1),
+		BodyEnergyParameter(ElasticEnergyModelType::kSimple, SimpleModelParameter(),
+							DissipationEnergyModelType::kRayleigh, RayleighModelParameter(0, 0),
+							ConstituteModelType::kStVK, StVKModelParameter(1e4, 0.47))
+	));
+	soft_body.UpdateSurface();
+	return soft_body;
+}
+
+RobotArm RotatedBox() {
+	return RobotArm(0.5, 1, Vector3d(1, 2, 3), Vector3d(0.1, 0.2, 0.3), Vector3d(1, 0.5, 0.5), Vector3d(0, 1, 0));
+}
+
+void AddArmRow(System &system) {
+	for (int i = 0; i < 6; i++) {
+		RobotArm arm(0.5, 1, Vector3d(0.3 * i, 0.1 * i, 0), Vector3d(0.1 * i, 0.2, 0.3 * i), Vector3d(1, 0.5, 0.5), Vector3d(1, 0, 0));
+		system.AddObject(arm);
+	}
+	system.UpdateSettings();
+}
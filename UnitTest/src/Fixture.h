@@ -0,0 +1,17 @@
+#ifndef FEM_FIXTURE_H
+#define FEM_FIXTURE_H
+
+#include "RigidBody/RobotArm.h"
+#include "SoftBody/SoftBody.h"
+#include "System/System.h"
+
+//-> the bunny as a StVK body at rest, with its surface updated
+SoftBody BunnySoftBody();
+
+//-> a box rotated out of the axes, off the origin
+RobotArm RotatedBox();
+
+//-> add a row of six overlapping arms to the system and update its settings
+void AddArmRow(System &system);
+
+#endif //FEM_FIXTURE_H
@@ -0,0 +1,110 @@
+#include "../Test.h"
+#include "Contact/DCDContactGenerator.h"
+#include "Contact/PolygonFrictionModel.h"
+#include "Contact/ConeFrictionModel.h"
+#include "Integrator/LCPIntegrator.h"
+#include "Fixture.h"
+#include <omp.h>
+
+void Test::TestFrictionJacobian() {
+	const SoftBody soft_body = BunnySoftBody();
+	const RowMatrixX3d vertices = soft_body.GetSurfacePosition();
+	const Vector3d lower = vertices.colwise().minCoeff(), upper = vertices.colwise().maxCoeff();
+
+	// an arm cutting through the bottom of the bunny
+	const Vector3d center((lower.x() + upper.x()) / 2, (lower.y() + upper.y()) / 2, lower.z());
+	const Vector3d size(2 * (upper.x() - lower.x()), 2 * (upper.y() - lower.y()), 0.4 * (upper.z() - lower.z()));
+	System system;
+	system.AddObject(soft_body);
+	system.AddObject(RobotArm(0.5, 1, center, Vector3d(0.1, 0.2, 0), size, Vector3d(0, 0, 1)));
+	system.UpdateSettings();
+
+	DCDContactGenerator generator;
+	generator.Initialize(DCDContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6)));
+	vector<ContactPoint> contacts;
+	generator.GetContact(system, contacts);
+	CPPUNIT_ASSERT(!contacts.empty());
+	contacts[0]._weight = 0.5;
+
+	const int num_tangent = 4;
+	PolygonFrictionModel friction_model;
+	friction_model.Initialize(PolygonFrictionModelParameter(num_tangent));
+	SparseMatrixXd JnT, JtT, parallel_JnT, parallel_JtT;
+	VectorXd Mu, parallel_Mu;
+	const int num_threads = omp_get_max_threads();
+	omp_set_num_threads(1);
+	friction_model.GetJ(system, contacts, JnT, JtT, Mu);
+	omp_set_num_threads(4);
+	friction_model.GetJ(system, contacts, parallel_JnT, parallel_JtT, parallel_Mu);
+	// nested in another region it runs on a single thread, the buffers of
+	// the others still holding the entries of the call before
+	SparseMatrixXd nested_JnT, nested_JtT;
+	VectorXd nested_Mu;
+	#pragma omp parallel num_threads(2)
+	{
+		#pragma omp single
+		friction_model.GetJ(system, contacts, nested_JnT, nested_JtT, nested_Mu);
+	}
+	omp_set_num_threads(num_threads);
+
+	// the rows are the directions times the Jacobians of the objects
+	const int num_contacts = contacts.size();
+	const auto& objects = system.GetObjects();
+	MatrixXd expected_Jn = MatrixXd::Zero(num_contacts, system.GetSysDOF());
+	MatrixXd expected_Jt = MatrixXd::Zero(num_contacts * num_tangent, system.GetSysDOF());
+	for (int c = 0; c < num_contacts; c++) {
+		const auto& contact = contacts[c];
+		const Vector3d& normal = contact._normal;
+		Vector3d tangent1(normal.z(), normal.z(), -normal.x() - normal.y());
+		tangent1.normalize();
+		const Vector3d tangent2 = tangent1.cross(normal);
+		const int objs[2] = {contact._obj1, contact._obj2}, idxs[2] = {contact._idx1, contact._idx2};
+		const Vector3d barycentrics[2] = {contact._barycentric1, contact._barycentric2};
+		for (int side = 0; side < 2; side++) {
+			const MatrixXd J = objects[objs[side]]->GetJ(idxs[side], barycentrics[side], contact._point);
+			const double weight = (side == 0 ? -1 : 1) * contact._weight;
+			const int offset = system.GetOffset(objs[side]);
+			expected_Jn.block(c, offset, 1, J.cols()) += weight * normal.transpose() * J;
+			for (int i = 0; i < num_tangent; i++) {
+				const double angle = 2 * EIGEN_PI * i / num_tangent;
+				const Vector3d tangent = std::cos(angle) * tangent1 + std::sin(angle) * tangent2;
+				expected_Jt.block(c * num_tangent + i, offset, 1, J.cols()) += weight * tangent.transpose() * J;
+			}
+		}
+	}
+	CPPUNIT_ASSERT((MatrixXd(JnT) - expected_Jn).norm() < 1e-10);
+	CPPUNIT_ASSERT((MatrixXd(JtT) - expected_Jt).norm() < 1e-10);
+	CPPUNIT_ASSERT(Mu.size() == num_contacts);
+
+	// and do not depend on the number of threads
+	CPPUNIT_ASSERT(MatrixXd(JnT) == MatrixXd(parallel_JnT));
+	CPPUNIT_ASSERT(MatrixXd(JtT) == MatrixXd(parallel_JtT));
+	CPPUNIT_ASSERT(Mu == parallel_Mu);
+	CPPUNIT_ASSERT(MatrixXd(JnT) == MatrixXd(nested_JnT));
+	CPPUNIT_ASSERT(MatrixXd(JtT) == MatrixXd(nested_JtT));
+}
+
+/**
+ * Compliance is opt-in, rigid contacts leave the LCP untouched and a
+ * stiffness k adds 1 / (k h^2) to the diagonal of the normal block
+ */
+void Test::TestContactCompliance() {
+	const int size = 12;
+	const double h = 0.01, stiffness = 1e7;
+
+	PolygonFrictionModel rigid_model, compliant_model;
+	rigid_model.Initialize(PolygonFrictionModelParameter(4));
+	compliant_model.Initialize(PolygonFrictionModelParameter(4, stiffness));
+	CPPUNIT_ASSERT(ConeFrictionModelParameter().GetStiffness() == 0);
+	CPPUNIT_ASSERT(rigid_model.GetCompliance(h) == 0);
+
+	MatrixXd M = MatrixXd::Random(size, size);
+	const MatrixXd A = M * M.transpose();
+	MatrixXd Ann = A;
+	LCPIntegrator::Regularize("normal", Ann, rigid_model.GetCompliance(h));
+	CPPUNIT_ASSERT(Ann == A);
+
+	LCPIntegrator::Regularize("normal", Ann, compliant_model.GetCompliance(h));
+	const MatrixXd expected = A + MatrixXd::Identity(size, size) / (stiffness * h * h);
+	CPPUNIT_ASSERT((Ann - expected).norm() < 1e-12 * expected.norm());
+}
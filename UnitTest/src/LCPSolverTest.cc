@@ -3,6 +3,14 @@
 //
 
 #include "../Test.h"
+#include "NumericSolver/LCPSolver/PGS.h"
+#include "NumericSolver/LCPSolver/BoxQP.h"
+#include "NumericSolver/LCPSolver/ConePGS.h"
+#include "NumericSolver/LCPSolver/AdaptiveLCPSolver.h"
+#include "Integrator/StaggerLCPIntegrator.h"
+#include "Contact/DCDContactGenerator.h"
+#include "Contact/PolygonFrictionModel.h"
+#include "Fixture.h"
 
 void Test::TestLCPCommon() {
 	const int size = 120;
@@ -73,6 +81,227 @@ void Test::TestLCPFrictionMatrix() {
 	}
 }
 
+/**
+ * Dense, sparse and factored operators of the same
+ * matrix should lead to the same solution
+ */
+void Test::TestLCPOperator() {
+	const int size = 30;
+	const int dof = 60;
+
+	RowSparseMatrixXd L = MatrixXd::Random(size, dof).sparseView(1, 0.8);
+	MatrixXd R = L.transpose();
+	MatrixXd A = L * R;
+	A.diagonal().array() += 1;
+	RowSparseMatrixXd A_sparse = A.sparseView();
+	VectorXd b = VectorXd::Random(size);
+
+	VectorXd x_dense = VectorXd::Zero(size), x_sparse = VectorXd::Zero(size);
+	_lcp_solver->Solve(DenseLCPOperator(A), b, x_dense);
+	_lcp_solver->Solve(SparseLCPOperator(A_sparse), b, x_sparse);
+
+	CPPUNIT_ASSERT((x_dense - x_sparse).norm() < 1e-8);
+	VectorXd y = A * x_dense + b;
+	for (int i = 0; i < size; i++) {
+		CPPUNIT_ASSERT(x_dense(i) > -_eps && y(i) > -1e-6 && std::abs(x_dense(i) * y(i)) < 1e-6);
+	}
+
+	// A without its diagonal shift, never formed
+	MatrixXd A_factored = L * R;
+	VectorXd x_factored = VectorXd::Zero(size);
+	_lcp_solver->Solve(FactoredLCPOperator(L, R), b, x_factored);
+	VectorXd x_reference = _lcp_solver->Solve(A_factored, b, VectorXd::Zero(size));
+	CPPUNIT_ASSERT((x_factored - x_reference).norm() < 1e-8);
+}
+
+/**
+ * Single precision sweeps followed by double precision
+ * refinement should reach the tolerance of double sweeps
+ */
+void Test::TestLCPMixedPrecision() {
+	const int size = 50;
+
+	MatrixXd M = MatrixXd::Random(size, size);
+	MatrixXd A = M * M.transpose() / size + MatrixXd::Identity(size, size);
+	VectorXd b = VectorXd::Random(size);
+
+	PGS mixed_solver;
+	mixed_solver.Initialize(PGSParameter(300, 1e-8, 1, true, 20));
+	VectorXd x_mixed = VectorXd::Zero(size);
+	mixed_solver.Solve(DenseLCPOperator(A), b, x_mixed);
+
+	PGS double_solver;
+	double_solver.Initialize(PGSParameter(300, 1e-8, 1));
+	VectorXd x_double = double_solver.Solve(A, b);
+
+	CPPUNIT_ASSERT((x_mixed - x_double).norm() < 1e-6);
+	VectorXd y = A * x_mixed + b;
+	for (int i = 0; i < size; i++) {
+		CPPUNIT_ASSERT(x_mixed(i) > -_eps && y(i) > -1e-6 && std::abs(x_mixed(i) * y(i)) < 1e-6);
+	}
+
+	// rounding an operator of the same shape again only refills the values
+	LCPRoundingBuffer buffer;
+	const MatrixXd A_scaled = 2 * A;
+	const RowSparseMatrixXd A_sparse = A.sparseView(), A_sparse_scaled = A_scaled.sparseView();
+	const auto* rounded = &DenseLCPOperator(A).Round(buffer);
+	const auto& rounded_scaled = DenseLCPOperator(A_scaled).Round(buffer);
+	CPPUNIT_ASSERT(&rounded_scaled == rounded);
+	CPPUNIT_ASSERT(std::abs(rounded_scaled.Diagonal(0) - A_scaled(0, 0)) < 1e-5 * std::abs(A_scaled(0, 0)));
+	rounded = &SparseLCPOperator(A_sparse).Round(buffer);
+	const auto& rounded_sparse_scaled = SparseLCPOperator(A_sparse_scaled).Round(buffer);
+	CPPUNIT_ASSERT(&rounded_sparse_scaled == rounded);
+	CPPUNIT_ASSERT(std::abs(rounded_sparse_scaled.Diagonal(0) - A_scaled(0, 0)) < 1e-5 * std::abs(A_scaled(0, 0)));
+}
+
+/**
+ * A bunny thrown onto an arm that cuts through its bottom, the staggering
+ * integrator should reach the same velocities with and without Anderson
+ * acceleration, and in fewer iterations with it
+ */
+void Test::TestAndersonAcceleration() {
+	const SoftBody soft_body = BunnySoftBody();
+	const RowMatrixX3d vertices = soft_body.GetSurfacePosition();
+	const Vector3d lower = vertices.colwise().minCoeff(), upper = vertices.colwise().maxCoeff();
+	const Vector3d center((lower.x() + upper.x()) / 2, (lower.y() + upper.y()) / 2, lower.z());
+	const Vector3d size(2 * (upper.x() - lower.x()), 2 * (upper.y() - lower.y()), 0.4 * (upper.z() - lower.z()));
+
+	DCDContactGenerator generator;
+	generator.Initialize(DCDContactGeneratorParameter(DCDType::kFast, DCDParameter(100, 1e-6)));
+	PolygonFrictionModel friction_model;
+	friction_model.Initialize(PolygonFrictionModelParameter(4));
+
+	const double h = 0.01;
+	const int max_step = 1000;
+	VectorXd velocities[2];
+	int num_steps[2];
+	const int windows[2] = {0, 5};
+	for (int k = 0; k < 2; k++) {
+		System system;
+		system.AddObject(soft_body);
+		system.AddObject(RobotArm(0.5, 1, center, Vector3d(0.1, 0.2, 0), size, Vector3d(0, 0, 1)));
+		system.UpdateSettings();
+		VectorXd& v = system.GetObjects()[0]->GetV();
+		for (int i = 0; i < v.size(); i += 3) {
+			v(i) = 1;
+			v(i + 2) = -1;
+		}
+
+		StaggerLCPIntegrator integrator;
+		integrator.Initialize(StaggerLCPIntegratorParameter(LCPSolverType::kPGS, PGSParameter(max_step, 1e-8, 1), windows[k]));
+		CPPUNIT_ASSERT(integrator.Step(system, generator, friction_model, h));
+		num_steps[k] = integrator.GetNumSteps();
+		CPPUNIT_ASSERT(num_steps[k] > 1 && num_steps[k] < max_step);
+		system.GetSysV(velocities[k]);
+	}
+	CPPUNIT_ASSERT(num_steps[1] < num_steps[0]);
+	CPPUNIT_ASSERT((velocities[0] - velocities[1]).norm() < 1e-5 * velocities[0].norm());
+}
+
+/**
+ * A zero diagonal makes PGS fail instead of exiting, and the adaptive
+ * solver should then fall back to the next backend
+ */
+void Test::TestAdaptiveFallback() {
+	const int size = 40;
+
+	MatrixXd M = MatrixXd::Random(size, size);
+	MatrixXd A = M * M.transpose() / size + MatrixXd::Identity(size, size);
+	A.row(0).setZero();
+	A.col(0).setZero();
+	VectorXd b = VectorXd::Random(size);
+	b(0) = 1;
+
+	PGS pgs;
+	pgs.Initialize(PGSParameter(300, 1e-8, 1));
+	VectorXd x_pgs = VectorXd::Zero(size);
+	pgs.Solve(DenseLCPOperator(A), b, x_pgs);
+	CPPUNIT_ASSERT(!pgs.IsConverged());
+
+	// every problem is large, so PGS is tried first
+	AdaptiveLCPSolver solver;
+	solver.Initialize(AdaptiveLCPSolverParameter(300, 1e-8, 0, 1));
+	VectorXd x = VectorXd::Zero(size);
+	solver.Solve(DenseLCPOperator(A), b, x);
+	CPPUNIT_ASSERT(solver.IsConverged());
+	CPPUNIT_ASSERT(std::string(solver.GetLastBackend()) == "BoxQP");
+
+	VectorXd y = A * x + b;
+	for (int i = 0; i < size; i++) {
+		CPPUNIT_ASSERT(x(i) > -_eps && y(i) > -1e-6 && std::abs(x(i) * y(i)) < 1e-6);
+	}
+}
+
+/**
+ * The box QP solver should solve LCPs of singular spd matrices,
+ * and a warm started solve of a perturbed problem should be short
+ */
+void Test::TestBoxQP() {
+	const int size = 60;
+
+	MatrixXd M = MatrixXd::Random(size, size / 2);
+	MatrixXd A = M * M.transpose() / size;
+	VectorXd x_star = VectorXd::Random(size).cwiseMax(0);
+	VectorXd y_star = VectorXd::Random(size).cwiseMax(0);
+	for (int i = 0; i < size; i++) {
+		if (x_star(i) > 0) {
+			y_star(i) = 0;
+		}
+	}
+	VectorXd b = y_star - A * x_star;
+
+	BoxQP solver;
+	solver.Initialize(BoxQPParameter(1000, 1e-8));
+	VectorXd x = solver.Solve(A, b);
+	CPPUNIT_ASSERT(solver.IsConverged());
+	VectorXd y = A * x + b;
+	for (int i = 0; i < size; i++) {
+		CPPUNIT_ASSERT(x(i) > -_eps && y(i) > -1e-6 && std::abs(x(i) * y(i)) < 1e-6);
+	}
+	const int cold_iterations = solver.GetNumIterations();
+
+	A.diagonal().array() += 1e-2;
+	solver.Solve(DenseLCPOperator(A), b, x);
+	CPPUNIT_ASSERT(solver.IsConverged());
+	CPPUNIT_ASSERT(solver.GetNumIterations() < cold_iterations);
+	y = A * x + b;
+	for (int i = 0; i < size; i++) {
+		CPPUNIT_ASSERT(x(i) > -_eps && y(i) > -1e-6 && std::abs(x(i) * y(i)) < 1e-6);
+	}
+}
+
+/**
+ * The solution of the cone PGS should lie in the friction
+ * cone, with Ax + b in the dual cone and orthogonal to it
+ */
+void Test::TestConePGS() {
+	const int num_contact = 20;
+	const int size = 3 * num_contact;
+
+	MatrixXd J = MatrixXd::Random(size, 2 * size);
+	MatrixXd A = J * J.transpose() / size;
+	A.diagonal().array() += 1e-3;
+	VectorXd b = VectorXd::Random(size);
+	for (int i = 0; i < num_contact; i++) {
+		b(3 * i) -= 0.5;	// pushing into each other
+	}
+	VectorXd mu = VectorXd::Constant(num_contact, 0.5);
+
+	ConePGS solver;
+	solver.Initialize(PGSParameter(5000, 1e-8, 1));
+	VectorXd x = VectorXd::Zero(size);
+	solver.Solve(DenseLCPOperator(A), b, mu, x);
+	CPPUNIT_ASSERT(solver.IsConverged());
+
+	VectorXd y = A * x + b;
+	for (int i = 0; i < num_contact; i++) {
+		const Vector3d x_i = x.segment<3>(3 * i), y_i = y.segment<3>(3 * i);
+		CPPUNIT_ASSERT(x_i.tail<2>().norm() < mu(i) * x_i(0) + 1e-6);
+		CPPUNIT_ASSERT(mu(i) * y_i.tail<2>().norm() < y_i(0) + 1e-6);
+		CPPUNIT_ASSERT(std::abs(x_i.dot(y_i)) < 1e-6);
+	}
+}
+
 void Test::TestLCPSmallScale() {
 
 }
\ No newline at end of file
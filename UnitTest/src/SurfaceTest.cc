@@ -0,0 +1,56 @@
+#include "../Test.h"
+#include "Fixture.h"
+#include <algorithm>
+
+void Test::TestRigidSurface() {
+	RobotArm arm = RotatedBox();
+	arm.UpdateSurface();
+	const RowMatrixX3d start = arm.GetSurfacePosition();
+
+	// the views read the cached surface in place, which is only refreshed
+	// by UpdateSurface
+	CPPUNIT_ASSERT(arm.GetSurfacePosition().data() == arm.GetSurfacePosition().data());
+	CPPUNIT_ASSERT(arm.GetSurfaceVelocity().isZero());
+
+	arm.GetX()(0) = 2;
+	arm.GetV()(0) = 3;
+	CPPUNIT_ASSERT(arm.GetSurfacePosition() == start);
+	arm.UpdateSurface();
+	const RowMatrixX3dRef position = arm.GetSurfacePosition();
+	const RowMatrixX3dRef velocity = arm.GetSurfaceVelocity();
+	CPPUNIT_ASSERT(position.rows() == start.rows());
+	for (int i = 0; i < position.rows(); i++) {
+		CPPUNIT_ASSERT((position.row(i) - start.row(i) - Eigen::RowVector3d(0, 2, 0)).norm() < 1e-10);
+		CPPUNIT_ASSERT((velocity.row(i) - Eigen::RowVector3d(0, 3, 0)).norm() < 1e-10);
+	}
+}
+
+void Test::TestSoftSurface() {
+	Mesh mesh;
+	mesh.Initialize(MeshParameter("../Resource/vtk/bunny.vtk"));
+	const auto& surface = mesh.GetSurface();
+	const auto& compact_surface = mesh.GetCompactSurface();
+	const auto& surface_points = mesh.GetSurfacePoints();
+
+	// the interior points are left out, and the compact surface is the same
+	CPPUNIT_ASSERT(3 * surface_points.size() < mesh.GetPoints().size());
+	CPPUNIT_ASSERT(std::is_sorted(surface_points.begin(), surface_points.end()));
+	CPPUNIT_ASSERT(compact_surface.rows() == surface.rows());
+	for (int i = 0; i < surface.rows(); i++) {
+		for (int j = 0; j < 3; j++) {
+			CPPUNIT_ASSERT(surface_points[compact_surface(i, j)] == surface(i, j));
+		}
+	}
+
+	SoftBody soft_body(mesh);
+	soft_body.GetX()(3 * surface_points[1] + 2) += 1;
+	soft_body.GetV()(3 * surface_points[2]) = 2;
+	soft_body.UpdateSurface();
+	const RowMatrixX3dRef position = soft_body.GetSurfacePosition();
+	const RowMatrixX3dRef velocity = soft_body.GetSurfaceVelocity();
+	CPPUNIT_ASSERT(position.rows() == surface_points.size());
+	for (int i = 0; i < position.rows(); i++) {
+		CPPUNIT_ASSERT(position.row(i).transpose() == soft_body.GetX().segment<3>(3 * surface_points[i]));
+		CPPUNIT_ASSERT(velocity.row(i).transpose() == soft_body.GetV().segment<3>(3 * surface_points[i]));
+	}
+}
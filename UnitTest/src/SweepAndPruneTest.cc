@@ -0,0 +1,35 @@
+#include "../Test.h"
+#include "Contact/BroadPhase/SweepAndPrune.h"
+
+void Test::TestSweepAndPrune() {
+	const int num_boxes = 50;
+	std::vector<AABB> boxes(num_boxes);
+	std::vector<Vector3d> velocities(num_boxes);
+	for (int i = 0; i < num_boxes; i++) {
+		const Vector3d center = 5 * Vector3d::Random();
+		boxes[i].Extend(center - Vector3d::Ones());
+		boxes[i].Extend(center + Vector3d::Ones());
+		velocities[i] = 0.1 * Vector3d::Random();
+	}
+
+	// the end points are sorted incrementally as the boxes move
+	SweepAndPrune sweep_and_prune;
+	std::vector<std::pair<int, int>> pairs, expected;
+	for (int step = 0; step < 20; step++) {
+		sweep_and_prune.GetPairs(boxes, pairs);
+		expected.clear();
+		for (int i1 = 0; i1 < num_boxes; i1++) {
+			for (int i2 = 0; i2 < i1; i2++) {
+				if (boxes[i1].Overlap(boxes[i2])) {
+					expected.emplace_back(i1, i2);
+				}
+			}
+		}
+		CPPUNIT_ASSERT(pairs == expected);
+
+		for (int i = 0; i < num_boxes; i++) {
+			boxes[i]._min += velocities[i];
+			boxes[i]._max += velocities[i];
+		}
+	}
+}
@@ -1,18 +1,24 @@
 #include "Simulator/Simulator.h"
 #include "NumericSolver/LCPSolver/BGS.h"
 #include "NumericSolver/LCPSolver/OSQPWrapper.h"
+#include "NumericSolver/LCPSolver/AdaptiveLCPSolver.h"
 #include "ElementEnergy/SimpleModel.h"
 #include "ElementEnergy/RayleighModel.h"
 #include "ConstituteModel/StVKModel.h"
 #include "Mass/VoronoiModel.h"
 #include "Integrator/LCPIntegrator.h"
+#include "Integrator/StaggerLCPIntegrator.h"
 #include "Contact/DCDContactGenerator.h"
+#include "Contact/SpatialHashContactGenerator.h"
+#include "Contact/CCDContactGenerator.h"
 #include "Contact/PolygonFrictionModel.h"
+#include "Contact/ConeFrictionModel.h"
 #include "Object/RigidBody/RobotArm.h"
 #include "Object/RigidBody/FixedSlab.h"
 #include "BodyEnergy/RobotArmForce.h"
 #include "BodyEnergy/SoftBodyGravity.h"
 #include "Output/FileOutput.h"
+#include "Util/Telemetry.h"
 #include "json/json.h"
 #include <iostream>
 
@@ -31,30 +37,84 @@ int main() {
 		exit(EXIT_FAILURE);
 	}
 
+	// Dump the contact problems for offline replay (see Benchmark/LCPReplay.cc)
+	const std::string record_file = root.get("solver-config", Json::nullValue).get("record-file", "").asString();
+
+	// Per-iteration residuals of the solvers as a csv stream
+	const std::string telemetry_file = root.get("solver-config", Json::nullValue).get("telemetry-file", "").asString();
+	if (!telemetry_file.empty()) {
+		Telemetry::GetInstance()->Open(RESOURCE_PATH + telemetry_file);
+	}
+
+	// "polygon" linearizes the friction cone, "cone" solves with the exact one
+	const auto& friction_config = root.get("friction-model", Json::nullValue);
+	const bool cone_friction = friction_config.get("type", "polygon").asString() == "cone";
+	const PolygonFrictionModelParameter polygon_friction_para(
+			friction_config.get("num-tangent", 4).asInt(),
+			friction_config.get("stiffness", 0).asDouble()
+	);
+	const ConeFrictionModelParameter cone_friction_para(friction_config.get("stiffness", 0).asDouble());
+
+	// "bvh" keeps a tree per object, "spatial-hash" hashes the triangles of all the objects into a grid,
+	// "ccd" sweeps the surfaces over the step so thin objects are not tunneled through
+	const auto& contact_config = root.get("contact-generator", Json::nullValue);
+	const std::string contact_type = contact_config.get("type", "bvh").asString();
+	const double time_step = root.get("simulation-config", Json::nullValue).get("time-step", 0.01).asDouble();
+	const DCDParameter dcd_para(
+			root.get("solver-config", Json::nullValue).get("max-iteration", 300).asInt(),
+			root.get("solver-config", Json::nullValue).get("tolerance", 1e-3).asDouble()
+	);
+	const int manifold_size = contact_config.get("manifold-size", 0).asInt();
+	// "analytic" tests the soft bodies by their vertices against the distance of the boxes
+	const RigidContactType rigid_contact = contact_config.get("rigid-contact", "triangle").asString() == "analytic"
+										   ? RigidContactType::kAnalytic : RigidContactType::kTriangle;
+	// a positive cell size bakes a distance field for each rigid body, used in place of the closed form
+	const double distance_field_cell = contact_config.get("distance-field-cell", 0).asDouble();
+	const DCDContactGeneratorParameter dcd_contact_para(
+			DCDType::kFast, dcd_para,
+			contact_config.get("self-collision", false).asBool(),
+			manifold_size, rigid_contact,
+			contact_config.get("cache-steps", 0).asInt()
+	);
+	const SpatialHashContactGeneratorParameter spatial_hash_para(
+			DCDType::kFast, dcd_para,
+			contact_config.get("cell-scale", 1).asDouble(),
+			manifold_size, rigid_contact
+	);
+	const CCDContactGeneratorParameter ccd_para(
+			time_step,
+			contact_config.get("contact-distance", 1e-4).asDouble(),
+			contact_config.get("toi-max-iteration", 100).asInt(),
+			manifold_size
+	);
+	ContactGeneratorType contact_generator_type = ContactGeneratorType::kDCD;
+	const ContactGeneratorParameter* contact_para = &dcd_contact_para;
+	if (contact_type == "spatial-hash") {
+		contact_generator_type = ContactGeneratorType::kSpatialHash;
+		contact_para = &spatial_hash_para;
+	} else if (contact_type == "ccd") {
+		contact_generator_type = ContactGeneratorType::kCCD;
+		contact_para = &ccd_para;
+	}
+
 	SimulatorParameter para(
 			root.get("simulation-config", Json::nullValue).get("duration", 5).asDouble(),
-			root.get("simulation-config", Json::nullValue).get("time-step", 0.01).asDouble(),
+			time_step,
 			SystemParameter(),
-			IntegratorType::kStaggeringLCP,
-			LCPIntegratorParameter(
-					LCPSolverType::kOSQP,
-					OSQPWrapperParameter (
+			cone_friction ? IntegratorType::kCone : IntegratorType::kStaggeringLCP,
+			StaggerLCPIntegratorParameter(
+					LCPSolverType::kAdaptive,
+					AdaptiveLCPSolverParameter (
 							root.get("solver-config", Json::nullValue).get("max-iteration", 300).asInt(),
 							root.get("solver-config", Json::nullValue).get("tolerance", 1e-3).asDouble()
-					)
-			),
-			ContactGeneratorType::kDCD,
-			DCDContactGeneratorParameter(
-					DCDType::kFast,
-					DCDParameter(
-							root.get("solver-config", Json::nullValue).get("max-iteration", 300).asInt(),
-							root.get("solver-config", Json::nullValue).get("tolerance", 1e-3).asDouble()
-					)
-			),
-			FrictionModelType::kInscribedPolygon,
-			PolygonFrictionModelParameter(
-					root.get("friction-model", Json::nullValue).get("num-tangent", 4).asInt()
+					),
+					root.get("solver-config", Json::nullValue).get("anderson-window", 0).asInt(),
+					record_file.empty() ? "" : RESOURCE_PATH + record_file
 			),
+			contact_generator_type,
+			*contact_para,
+			cone_friction ? FrictionModelType::kCone : FrictionModelType::kInscribedPolygon,
+			cone_friction ? static_cast<const FrictionModelParameter&>(cone_friction_para) : polygon_friction_para,
 			SimulatorOutputType::kFile,
 			FileOutputParameter (
 					RESOURCE_PATH + root.get("output-dir", Json::nullValue).asString()
@@ -126,6 +186,9 @@ int main() {
 					 robot_arm_config.get("dir-z", Json::nullValue).asDouble();
 		RobotArm robot_arm(mu, density, center, euler, shape, direction);
 		robot_arm.AddExternalForce(RobotArmForce(direction, force));
+		if (distance_field_cell > 0) {
+			robot_arm.BakeDistanceField(distance_field_cell);
+		}
 		app.AddObject(robot_arm);
 	}
 
@@ -147,7 +210,11 @@ int main() {
 				fixed_slab_config.get("theta", Json::nullValue).asDouble(),
 				fixed_slab_config.get("psi", Json::nullValue).asDouble();
 
-		app.AddObject(FixedSlab(mu, density, center, euler, shape));
+		FixedSlab fixed_slab(mu, density, center, euler, shape);
+		if (distance_field_cell > 0) {
+			fixed_slab.BakeDistanceField(distance_field_cell);
+		}
+		app.AddObject(fixed_slab);
 	}
 //	app.Simulate();
 	app.MainLoop();